@@ -1,35 +1,10 @@
 #include "api_dto.h"
 #include "model.h"
 #include "validator.h" // если там есть makeDate / twoDigits
+#include "instance_index.h"
 #include <vector>
 #include <string>
 
-// простая утилита для поиска по id
-const Group*  findGroupById_ui (const std::vector<Group>& groups, int id) {
-    for (const Group& g : groups) if (g.id == id) return &g;
-    return nullptr;
-}
-
-const Teacher* findTeacherById_ui (const std::vector<Teacher>& teachers, int id) {
-    for (const Teacher& t : teachers) if (t.id == id) return &t;
-    return nullptr;
-}
-
-const Subject* findSubjectById_ui (const std::vector<Subject>& subjects, int id) {
-    for (const Subject& s : subjects) if (s.id == id) return &s;
-    return nullptr;
-}
-
-const Room* findRoomById_ui (const std::vector<Room>& rooms, int id) {
-    for (const Room& r : rooms) if (r.id == id) return &r;
-    return nullptr;
-}
-
-const Timeslot* findTimeslotById_ui (const std::vector<Timeslot>& slots, int id) {
-    for (const Timeslot& t : slots) if (t.id == id) return &t;
-    return nullptr;
-}
-
 // форматируем время "HH:MM"
 std::string formatTime(int minutesFromMidnight) {
     int h = minutesFromMidnight / 60;
@@ -47,17 +22,27 @@ std::vector<ExamView> buildExamViews(
     const std::vector<Room>& rooms,
     const std::vector<Timeslot>& timeslots,
     const std::vector<ExamAssignment>& assignments
+) {
+    InstanceIndex index(groups, teachers, subjects, rooms, timeslots);
+    return buildExamViews(exams, index, assignments);
+}
+
+std::vector<ExamView> buildExamViews(
+    const std::vector<Exam>& exams,
+    const InstanceIndex& index,
+    const std::vector<ExamAssignment>& assignments
 ) {
     std::vector<ExamView> result;
+    result.reserve(assignments.size());
 
     for (const ExamAssignment& a : assignments) {
         const Exam& exam = exams[a.examIndex];
 
-        const Group*     g = findGroupById_ui(groups, exam.groupId);
-        const Teacher*   t = findTeacherById_ui(teachers, exam.teacherId);
-        const Subject*   s = findSubjectById_ui(subjects, exam.subjectId);
-        const Room*      r = (a.roomId >= 0 ? findRoomById_ui(rooms, a.roomId) : nullptr);
-        const Timeslot*  ts = findTimeslotById_ui(timeslots, a.timeslotId);
+        const Group*     g = index.findGroup(exam.groupId);
+        const Teacher*   t = index.findTeacher(exam.teacherId);
+        const Subject*   s = index.findSubject(exam.subjectId);
+        const Room*      r = (a.roomId >= 0 ? index.findRoom(a.roomId) : nullptr);
+        const Timeslot*  ts = index.findTimeslot(a.timeslotId);
 
         ExamView ev;
         ev.examId      = exam.id;
@@ -65,6 +50,8 @@ std::vector<ExamView> buildExamViews(
         ev.teacherName = t ? t->name : "Неизвестный преподаватель";
         ev.subjectName = s ? s->name : "Неизвестный предмет";
         ev.roomName    = r ? r->name : "Не назначена";
+        ev.timeslotId  = ts ? ts->id : -1;
+        ev.roomId      = r ? r->id : -1;
         if (ts) {
             ev.date       = ts->date;
             ev.startTime  = formatTime(ts->startMinutes);
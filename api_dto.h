@@ -12,13 +12,15 @@ struct ExamView {
     std::string date;       // "2025-01-20"
     std::string startTime;  // "09:00"
     std::string endTime;    // "11:00"
+    int timeslotId = -1;    // id из config, -1 — слот не найден
+    int roomId = -1;        // id из config, -1 — без аудитории
 };
 
 struct ApiResponse {
     std::string algorithm;              // "graph" / "simple"
     std::vector<ExamView> schedule;     // то, что идёт в mockData.schedule
     bool ok;                            // validation.ok
-    std::vector<std::string> errors;    // validation.errors
+    std::vector<std::string> errors;    // renderViolations(validation, index)
 };
 
 // объявление функций
@@ -30,6 +32,7 @@ class Timeslot;
 class Exam;
 struct ExamAssignment;
 struct ValidationResult;
+class InstanceIndex;
 
 std::vector<ExamView> buildExamViews(
     const std::vector<Exam>& exams,
@@ -41,4 +44,10 @@ std::vector<ExamView> buildExamViews(
     const std::vector<ExamAssignment>& assignments
 );
 
+std::vector<ExamView> buildExamViews(
+    const std::vector<Exam>& exams,
+    const InstanceIndex& index,
+    const std::vector<ExamAssignment>& assignments
+);
+
 void printApiResponseJson(const ApiResponse& resp);
@@ -31,38 +31,40 @@ static std::string escapeJson(const std::string& s) {
 
 #include <sstream>
 
+// Компактный JSON без отступов: ответы с расписанием на несколько тысяч
+// экзаменов занимают мегабайты, и отступы были заметной их частью
 std::string buildApiResponseJsonString(const ApiResponse& resp) {
     std::ostringstream out;
 
-    out << "{\n";
-    out << "  \"algorithm\": \"" << escapeJson(resp.algorithm) << "\",\n";
-    out << "  \"validation\": {\n";
-    out << "    \"ok\": " << (resp.ok ? "true" : "false") << ",\n";
-    out << "    \"errors\": [\n";
+    out << "{";
+    out << "\"algorithm\":\"" << escapeJson(resp.algorithm) << "\",";
+    out << "\"validation\":{";
+    out << "\"ok\":" << (resp.ok ? "true" : "false") << ",";
+    out << "\"errors\":[";
     for (size_t i = 0; i < resp.errors.size(); ++i) {
-        out << "      \"" << escapeJson(resp.errors[i]) << "\"";
-        if (i + 1 != resp.errors.size()) out << ",";
-        out << "\n";
+        if (i) out << ",";
+        out << "\"" << escapeJson(resp.errors[i]) << "\"";
     }
-    out << "    ]\n";
-    out << "  },\n";
-    out << "  \"schedule\": [\n";
+    out << "]";
+    out << "},";
+    out << "\"schedule\":[";
     for (size_t i = 0; i < resp.schedule.size(); ++i) {
         const ExamView& e = resp.schedule[i];
-        out << "    {\n";
-        out << "      \"examId\": "      << e.examId                    << ",\n";
-        out << "      \"groupName\": \""   << escapeJson(e.groupName)   << "\",\n";
-        out << "      \"teacherName\": \"" << escapeJson(e.teacherName) << "\",\n";
-        out << "      \"subjectName\": \"" << escapeJson(e.subjectName) << "\",\n";
-        out << "      \"roomName\": \""    << escapeJson(e.roomName)    << "\",\n";
-        out << "      \"date\": \""        << escapeJson(e.date)        << "\",\n";
-        out << "      \"startTime\": \""   << escapeJson(e.startTime)   << "\",\n";
-        out << "      \"endTime\": \""     << escapeJson(e.endTime)     << "\"\n";
-        out << "    }";
-        if (i + 1 != resp.schedule.size()) out << ",";
-        out << "\n";
+        if (i) out << ",";
+        out << "{";
+        out << "\"examId\":"        << e.examId                    << ",";
+        out << "\"groupName\":\""   << escapeJson(e.groupName)   << "\",";
+        out << "\"teacherName\":\"" << escapeJson(e.teacherName) << "\",";
+        out << "\"subjectName\":\"" << escapeJson(e.subjectName) << "\",";
+        out << "\"roomName\":\""    << escapeJson(e.roomName)    << "\",";
+        out << "\"date\":\""        << escapeJson(e.date)        << "\",";
+        out << "\"startTime\":\""   << escapeJson(e.startTime)   << "\",";
+        out << "\"endTime\":\""     << escapeJson(e.endTime)     << "\",";
+        out << "\"timeslotId\":"     << e.timeslotId                << ",";
+        out << "\"roomId\":"         << e.roomId;
+        out << "}";
     }
-    out << "  ]\n";
+    out << "]";
     out << "}\n";
 
     return out.str();
@@ -0,0 +1,89 @@
+// bitops.h — битовые операции над 64-битными словами и выровненное хранилище
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Размер кэш-линии, по которой выравниваем битовые матрицы
+constexpr std::size_t kCacheLineBytes = 64;
+constexpr int kWordBits = 64;
+
+inline int popcount64(uint64_t x) {
+#if defined(_MSC_VER)
+    return (int)__popcnt64(x);
+#else
+    return __builtin_popcountll(x);
+#endif
+}
+
+// Номер младшего установленного бита (x != 0)
+inline int ctz64(uint64_t x) {
+#if defined(_MSC_VER)
+    unsigned long idx;
+    _BitScanForward64(&idx, x);
+    return (int)idx;
+#else
+    return __builtin_ctzll(x);
+#endif
+}
+
+// Номер старшего установленного бита (x != 0)
+inline int msb64(uint64_t x) {
+#if defined(_MSC_VER)
+    unsigned long idx;
+    _BitScanReverse64(&idx, x);
+    return (int)idx;
+#else
+    return 63 - __builtin_clzll(x);
+#endif
+}
+
+// Сколько 64-битных слов нужно под bitsCount бит
+inline int wordsForBits(int bitsCount) {
+    return (bitsCount + kWordBits - 1) / kWordBits;
+}
+
+// Аллокатор, выравнивающий начало буфера по кэш-линии
+template <typename T>
+struct CacheAlignedAllocator {
+    using value_type = T;
+
+    CacheAlignedAllocator() = default;
+    template <typename U>
+    CacheAlignedAllocator(const CacheAlignedAllocator<U>&) {}
+
+    T* allocate(std::size_t count) {
+        return static_cast<T*>(::operator new(
+            count * sizeof(T), std::align_val_t(kCacheLineBytes)));
+    }
+
+    void deallocate(T* p, std::size_t) {
+        ::operator delete(p, std::align_val_t(kCacheLineBytes));
+    }
+
+    template <typename U>
+    bool operator==(const CacheAlignedAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const CacheAlignedAllocator<U>&) const { return false; }
+};
+
+// Непрерывный массив слов битового множества
+using BitWords = std::vector<uint64_t, CacheAlignedAllocator<uint64_t>>;
+
+inline bool testBit(const uint64_t* words, int i) {
+    return (words[i / kWordBits] >> (i % kWordBits)) & 1ULL;
+}
+
+inline void setBit(uint64_t* words, int i) {
+    words[i / kWordBits] |= (1ULL << (i % kWordBits));
+}
+
+inline void clearBit(uint64_t* words, int i) {
+    words[i / kWordBits] &= ~(1ULL << (i % kWordBits));
+}
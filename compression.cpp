@@ -0,0 +1,109 @@
+// compression.cpp
+#include "compression.h"
+
+#include <zlib.h>
+#include <brotli/encode.h>
+
+#include <cctype>
+#include <cstdlib>
+
+const char* contentEncodingName(ContentEncoding encoding) {
+    switch (encoding) {
+        case ContentEncoding::Identity: return "identity";
+        case ContentEncoding::Gzip: return "gzip";
+        case ContentEncoding::Brotli: return "br";
+    }
+    return "identity";
+}
+
+std::string gzipCompress(const std::string& data, int level) {
+    z_stream strm{};
+    // 15 бит окна + 16 — заголовок gzip вместо zlib
+    if (deflateInit2(&strm, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return {};
+    }
+
+    std::string out;
+    out.resize(deflateBound(&strm, data.size()));
+
+    strm.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    strm.avail_in = data.size();
+    strm.next_out = reinterpret_cast<Bytef*>(&out[0]);
+    strm.avail_out = out.size();
+
+    int ret = deflate(&strm, Z_FINISH);
+    std::size_t written = strm.total_out;
+    deflateEnd(&strm);
+
+    if (ret != Z_STREAM_END) {
+        return {};
+    }
+    out.resize(written);
+    return out;
+}
+
+std::string brotliCompress(const std::string& data, int quality) {
+    std::size_t size = BrotliEncoderMaxCompressedSize(data.size());
+    if (size == 0) {
+        return {};
+    }
+
+    std::string out;
+    out.resize(size);
+    if (!BrotliEncoderCompress(quality, BROTLI_DEFAULT_WINDOW, BROTLI_MODE_TEXT,
+                               data.size(), reinterpret_cast<const uint8_t*>(data.data()),
+                               &size, reinterpret_cast<uint8_t*>(&out[0]))) {
+        return {};
+    }
+    out.resize(size);
+    return out;
+}
+
+namespace {
+
+std::string lowerTrimmed(const std::string& s, std::size_t b, std::size_t e) {
+    while (b < e && std::isspace((unsigned char)s[b])) ++b;
+    while (e > b && std::isspace((unsigned char)s[e - 1])) --e;
+    std::string out = s.substr(b, e - b);
+    for (char& c : out) c = std::tolower((unsigned char)c);
+    return out;
+}
+
+} // namespace
+
+ContentEncoding negotiateEncoding(const std::string& acceptEncoding, bool haveGzip, bool haveBrotli) {
+    // -1 — кодирование в заголовке не названо
+    double qGzip = -1.0, qBrotli = -1.0, qAny = -1.0;
+
+    std::size_t pos = 0;
+    while (pos < acceptEncoding.size()) {
+        std::size_t end = acceptEncoding.find(',', pos);
+        if (end == std::string::npos) end = acceptEncoding.size();
+
+        std::size_t semi = acceptEncoding.find(';', pos);
+        std::size_t nameEnd = (semi != std::string::npos && semi < end) ? semi : end;
+        std::string name = lowerTrimmed(acceptEncoding, pos, nameEnd);
+
+        double q = 1.0;
+        if (nameEnd < end) {
+            std::string param = lowerTrimmed(acceptEncoding, nameEnd + 1, end);
+            if (param.compare(0, 2, "q=") == 0) {
+                q = std::atof(param.c_str() + 2);
+            }
+        }
+
+        if (name == "gzip" || name == "x-gzip") qGzip = q;
+        else if (name == "br") qBrotli = q;
+        else if (name == "*") qAny = q;
+
+        pos = end + 1;
+    }
+
+    if (qGzip < 0) qGzip = qAny;
+    if (qBrotli < 0) qBrotli = qAny;
+
+    if (haveBrotli && qBrotli > 0 && qBrotli >= qGzip) return ContentEncoding::Brotli;
+    if (haveGzip && qGzip > 0) return ContentEncoding::Gzip;
+    if (haveBrotli && qBrotli > 0) return ContentEncoding::Brotli;
+    return ContentEncoding::Identity;
+}
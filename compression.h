@@ -0,0 +1,24 @@
+// compression.h — сжатие тел ответов и выбор кодирования по Accept-Encoding
+#pragma once
+
+#include <string>
+
+enum class ContentEncoding {
+    Identity,
+    Gzip,
+    Brotli
+};
+
+// "identity" / "gzip" / "br" — значение для заголовка Content-Encoding
+const char* contentEncodingName(ContentEncoding encoding);
+
+// Тело в формате gzip (RFC 1952); пустая строка — ошибка zlib
+std::string gzipCompress(const std::string& data, int level = 9);
+
+// Тело в формате brotli (RFC 7932); пустая строка — ошибка кодировщика
+std::string brotliCompress(const std::string& data, int quality = 9);
+
+// Лучшее кодирование из доступных, которое клиент принимает: с наибольшим q
+// в Accept-Encoding, при равенстве — br, затем gzip. "*" относится ко всем
+// не названным явно, q=0 — запрет. Пустой заголовок — Identity.
+ContentEncoding negotiateEncoding(const std::string& acceptEncoding, bool haveGzip, bool haveBrotli);
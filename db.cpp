@@ -8,9 +8,12 @@
 #include <stdexcept>
 #include <sstream>
 #include <memory>
+#include <algorithm>
 
 #include <pqxx/pqxx>
 
+#include "logger.h"
+
 namespace db {
 
 // ==================== DbConfig::fromEnv ====================
@@ -26,6 +29,18 @@ static std::string getEnvOrThrow(const char* name) {
     return std::string(val);
 }
 
+// Необязательный числовой параметр: при ошибке разбора — значение по умолчанию
+static int envIntOr(const char* name, int fallback) {
+    const char* val = std::getenv(name);
+    if (!val) return fallback;
+    try {
+        return std::stoi(val);
+    } catch (...) {
+        logWarning(std::string("Некорректное значение ") + name + "=" + val + ", используем " + std::to_string(fallback));
+        return fallback;
+    }
+}
+
 DbConfig DbConfig::fromEnv() {
     DbConfig cfg;
     cfg.host     = getEnvOrThrow("KURSACH_DB_HOST");
@@ -36,13 +51,218 @@ DbConfig DbConfig::fromEnv() {
     const char* portStr = std::getenv("KURSACH_DB_PORT");
     cfg.port = portStr ? std::stoi(portStr) : 5432; // по умолчанию 5432
 
+    // пул: необязательные, без них — значения по умолчанию из DbConfig
+    cfg.poolMin = envIntOr("KURSACH_DB_POOL_MIN", cfg.poolMin);
+    cfg.poolMax = envIntOr("KURSACH_DB_POOL_MAX", cfg.poolMax);
+    cfg.poolWaitMs = envIntOr("KURSACH_DB_POOL_WAIT_MS", cfg.poolWaitMs);
+    cfg.poolCheckIdleMs = envIntOr("KURSACH_DB_POOL_CHECK_IDLE_MS", cfg.poolCheckIdleMs);
+
+    // poolMin <= poolMax, иначе пул не сможет открыть обязательные соединения
+    cfg.poolMax = std::max(1, cfg.poolMax);
+    cfg.poolMin = std::clamp(cfg.poolMin, 0, cfg.poolMax);
+    cfg.poolWaitMs = std::max(0, cfg.poolWaitMs);
+    cfg.poolCheckIdleMs = std::max(0, cfg.poolCheckIdleMs);
+
     return cfg;
 }
 
+// ==================== Подготовленные запросы ====================
+
+namespace {
+
+struct PreparedStatement {
+    const char* name;
+    const char* sql;
+};
+
+// Единственное место, где живёт текст запросов. Каждое соединение пула
+// готовит их один раз при открытии, дальше запросы идут по имени.
+const PreparedStatement kPreparedStatements[] = {
+    {stmt::kFindUserByUsername, R"SQL(
+        SELECT id, username, password_hash, role, email_plain
+        FROM app_user
+        WHERE username = $1
+    )SQL"},
+    {stmt::kCreateUser, R"SQL(
+        INSERT INTO app_user (username, password_hash, role)
+        VALUES ($1, $2, $3)
+        RETURNING id
+    )SQL"},
+    {stmt::kCreateUserWithEmail, R"SQL(
+        INSERT INTO app_user (username, password_hash, role, email_plain)
+        VALUES ($1, $2, $3, $4)
+        RETURNING id
+    )SQL"},
+    {stmt::kCreateSchedule, R"SQL(
+        INSERT INTO exam_schedule (user_id, name, config_json, result_json, is_public)
+        VALUES ($1, $2, $3, $4, FALSE)
+        RETURNING id
+    )SQL"},
+    {stmt::kFindPublishedSchedule, R"SQL(
+        SELECT
+            id,
+            user_id,
+            COALESCE(name, '')      AS name,
+            config_json::text       AS config_json,
+            result_json::text       AS result_json,
+            created_at,
+            updated_at,
+            is_public
+        FROM exam_schedule
+        WHERE is_public = TRUE
+        ORDER BY published_at DESC, id DESC
+        LIMIT 1
+    )SQL"},
+    {stmt::kFindSchedulesByUser, R"SQL(
+        SELECT
+            id,
+            user_id,
+            COALESCE(name, '')        AS name,
+            config_json::text         AS config_json,
+            result_json::text         AS result_json,
+            created_at,
+            updated_at,
+            is_public
+        FROM exam_schedule
+        WHERE user_id = $1
+        ORDER BY created_at DESC, id DESC
+    )SQL"},
+    {stmt::kListScheduleSummaries, R"SQL(
+        SELECT
+            id,
+            COALESCE(name, '')        AS name,
+            created_at,
+            updated_at,
+            is_public,
+            CASE WHEN jsonb_typeof(result_json->'schedule') = 'array'
+                 THEN jsonb_array_length(result_json->'schedule')
+                 ELSE 0
+            END                       AS exam_count,
+            COALESCE((result_json->'validation'->>'ok')::boolean, FALSE) AS validation_ok
+        FROM exam_schedule
+        WHERE user_id = $1
+          AND ($2::bigint IS NULL OR (created_at, id) < (
+                SELECT c.created_at, c.id
+                FROM exam_schedule c
+                WHERE c.id = $2
+                  AND c.user_id = $1
+              ))
+        ORDER BY created_at DESC, id DESC
+        LIMIT $3
+    )SQL"},
+    {stmt::kFindScheduleById, R"SQL(
+        SELECT
+            id,
+            user_id,
+            COALESCE(name, '')        AS name,
+            config_json::text         AS config_json,
+            result_json::text         AS result_json,
+            created_at,
+            updated_at,
+            is_public
+        FROM exam_schedule
+        WHERE id = $1
+          AND user_id = $2
+        LIMIT 1
+    )SQL"},
+    {stmt::kUpdateSchedule, R"SQL(
+        UPDATE exam_schedule
+        SET config_json = $3,
+            result_json = $4,
+            updated_at  = NOW()
+        WHERE id = $1
+          AND user_id = $2
+        RETURNING id
+    )SQL"},
+    {stmt::kUnpublishAll, R"SQL(
+        UPDATE exam_schedule SET is_public = FALSE
+    )SQL"},
+    {stmt::kPublishSchedule, R"SQL(
+        UPDATE exam_schedule
+        SET is_public = TRUE,
+            published_at = NOW()
+        WHERE id = $1
+        RETURNING id
+    )SQL"},
+    {stmt::kLatestResult, R"SQL(
+        SELECT result_json
+        FROM exam_schedule
+        ORDER BY created_at DESC
+        LIMIT 1
+    )SQL"},
+    {stmt::kLatestSchedule, R"SQL(
+        SELECT id, user_id, COALESCE(name, '') AS name,
+               config_json::text AS config_json,
+               result_json::text AS result_json,
+               created_at, updated_at
+        FROM exam_schedule
+        ORDER BY created_at DESC, id DESC
+        LIMIT 1
+    )SQL"},
+    {stmt::kPing, "SELECT 1"},
+    {stmt::kNotify, "SELECT pg_notify($1, $2)"},
+};
+
+} // namespace
+
+// Запрос, который не удалось подготовить (например, схема БД старше кода),
+// только пишется в лог: соединение остаётся рабочим для остальных запросов,
+// а ошибка всплывёт при вызове именно этого запроса
+void prepareStatements(pqxx::connection& conn) {
+    for (const PreparedStatement& s : kPreparedStatements) {
+        try {
+            conn.prepare(s.name, s.sql);
+        } catch (const std::exception& ex) {
+            logError(std::string("Не удалось подготовить запрос ") + s.name + ": " + ex.what());
+        }
+    }
+}
+
+// ==================== PooledConnection ====================
+
+PooledConnection::PooledConnection(PooledConnection&& other) noexcept
+    : owner_(other.owner_), conn_(std::move(other.conn_)) {
+    other.owner_ = nullptr;
+}
+
+PooledConnection& PooledConnection::operator=(PooledConnection&& other) noexcept {
+    if (this != &other) {
+        release();
+        owner_ = other.owner_;
+        conn_ = std::move(other.conn_);
+        other.owner_ = nullptr;
+    }
+    return *this;
+}
+
+PooledConnection::~PooledConnection() {
+    release();
+}
+
+void PooledConnection::release() {
+    if (owner_ && conn_) {
+        owner_->giveBack(std::move(conn_));
+    }
+    owner_ = nullptr;
+}
+
 // ==================== ConnectionFactory ====================
 
 ConnectionFactory::ConnectionFactory(const DbConfig& cfg)
-    : config(cfg) {}
+    : config(cfg) {
+    // прогрев: если БД пока недоступна, сервер всё равно стартует,
+    // соединения откроются при первых запросах
+    try {
+        for (int i = 0; i < config.poolMin; ++i) {
+            idle_.push_back({createConnection(), std::chrono::steady_clock::now()});
+            ++open_;
+        }
+    } catch (const std::exception& ex) {
+        logWarning(std::string("Пул БД: не удалось открыть соединения при старте: ") + ex.what());
+    }
+    logInfo("Пул БД: открыто=" + std::to_string(open_) +
+            ", максимум=" + std::to_string(config.poolMax));
+}
 
 std::unique_ptr<pqxx::connection> ConnectionFactory::createConnection() const {
     std::stringstream ss;
@@ -52,7 +272,89 @@ std::unique_ptr<pqxx::connection> ConnectionFactory::createConnection() const {
        << " user=" << config.user
        << " password=" << config.password;
 
-    return std::make_unique<pqxx::connection>(ss.str());
+    auto conn = std::make_unique<pqxx::connection>(ss.str());
+    prepareStatements(*conn);
+    return conn;
+}
+
+bool ConnectionFactory::healthy(
+    pqxx::connection& conn,
+    std::chrono::steady_clock::time_point idleSince
+) const {
+    if (!conn.is_open()) {
+        return false;
+    }
+
+    // недавно возвращённое соединение не проверяем запросом — это лишний round-trip
+    auto idle = std::chrono::steady_clock::now() - idleSince;
+    if (idle < std::chrono::milliseconds(config.poolCheckIdleMs)) {
+        return true;
+    }
+
+    try {
+        pqxx::nontransaction tx(conn);
+        tx.exec_prepared(stmt::kPing);
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+PooledConnection ConnectionFactory::acquire() {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(config.poolWaitMs);
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (true) {
+        // последнее возвращённое — самое «свежее», его реже нужно проверять
+        while (!idle_.empty()) {
+            IdleConnection item = std::move(idle_.back());
+            idle_.pop_back();
+            lock.unlock();
+
+            if (healthy(*item.conn, item.since)) {
+                return PooledConnection(this, std::move(item.conn));
+            }
+
+            logWarning("Пул БД: соединение оборвано, открываем заново");
+            item.conn.reset();
+            lock.lock();
+            --open_;
+        }
+
+        if (open_ < config.poolMax) {
+            ++open_;
+            lock.unlock();
+            try {
+                return PooledConnection(this, createConnection());
+            } catch (...) {
+                lock.lock();
+                --open_;
+                lock.unlock();
+                cv_.notify_one();
+                throw;
+            }
+        }
+
+        if (cv_.wait_until(lock, deadline) == std::cv_status::timeout &&
+            idle_.empty() && open_ >= config.poolMax) {
+            throw std::runtime_error(
+                "DB pool: no free connection within " + std::to_string(config.poolWaitMs) + " ms"
+            );
+        }
+    }
+}
+
+void ConnectionFactory::giveBack(std::unique_ptr<pqxx::connection> conn) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (conn && conn->is_open()) {
+            idle_.push_back({std::move(conn), std::chrono::steady_clock::now()});
+        } else {
+            // оборванное соединение в пул не возвращаем — следующий acquire откроет новое
+            --open_;
+        }
+    }
+    cv_.notify_one();
 }
 
 // ==================== UserRepository ====================
@@ -61,15 +363,10 @@ UserRepository::UserRepository(ConnectionFactory& f)
     : factory(f) {}
 
 std::optional<DbUser> UserRepository::findUserByUsername(const std::string& username) {
-    auto conn = factory.createConnection();
+    auto conn = factory.acquire();
     pqxx::work tx(*conn);
 
-    auto res = tx.exec_params(
-        "SELECT id, username, password_hash, role, email_plain "
-        "FROM app_user "
-        "WHERE username = $1",
-        username
-    );
+    auto res = tx.exec_prepared(stmt::kFindUserByUsername, username);
 
     if (res.empty()) {
         return std::nullopt;
@@ -96,30 +393,22 @@ long UserRepository::createUser(const std::string& username,
                                 const std::string& passwordHash,
                                 const std::string& role,
                                 const std::optional<std::string>& email) {
-    auto conn = factory.createConnection();
+    auto conn = factory.acquire();
     pqxx::work tx(*conn);
 
     pqxx::row row;
 
     if (email.has_value() && !email->empty()) {
-        row = tx.exec_params1(
-            R"SQL(
-                INSERT INTO app_user (username, password_hash, role, email_plain)
-                VALUES ($1, $2, $3, $4)
-                RETURNING id
-            )SQL",
+        row = tx.exec_prepared1(
+            stmt::kCreateUserWithEmail,
             username,
             passwordHash,
             role,
             *email
         );
     } else {
-        row = tx.exec_params1(
-            R"SQL(
-                INSERT INTO app_user (username, password_hash, role)
-                VALUES ($1, $2, $3)
-                RETURNING id
-            )SQL",
+        row = tx.exec_prepared1(
+            stmt::kCreateUser,
             username,
             passwordHash,
             role
@@ -138,18 +427,14 @@ long ScheduleRepository::createSchedule(
     const std::string& resultJson,
     const std::optional<std::string>& name
 ) {
-    auto conn = factory_.createConnection();
+    auto conn = factory_.acquire();
     pqxx::work tx(*conn);
 
     std::string nameStr = name.value_or("");
 
     // is_public по умолчанию FALSE
-    auto r = tx.exec_params(
-        R"SQL(
-            INSERT INTO exam_schedule (user_id, name, config_json, result_json, is_public)
-            VALUES ($1, $2, $3, $4, FALSE)
-            RETURNING id
-        )SQL",
+    auto r = tx.exec_prepared(
+        stmt::kCreateSchedule,
         userId,
         nameStr,
         configJson,
@@ -157,31 +442,15 @@ long ScheduleRepository::createSchedule(
     );
 
     long newId = r[0]["id"].as<long>();
-    tx.commit();
+    changed(tx, newId);
     return newId;
 }
 
 std::optional<DbSchedule> ScheduleRepository::findPublishedSchedule() {
-    auto conn = factory_.createConnection();
+    auto conn = factory_.acquire();
     pqxx::work tx(*conn);
 
-    auto r = tx.exec(
-        R"SQL(
-            SELECT
-                id,
-                user_id,
-                COALESCE(name, '')      AS name,
-                config_json::text       AS config_json,
-                result_json::text       AS result_json,
-                created_at,
-                updated_at,
-                is_public
-            FROM exam_schedule
-            WHERE is_public = TRUE
-            ORDER BY published_at DESC, id DESC
-            LIMIT 1
-        )SQL"
-    );
+    auto r = tx.exec_prepared(stmt::kFindPublishedSchedule);
 
     tx.commit();
 
@@ -206,25 +475,10 @@ std::optional<DbSchedule> ScheduleRepository::findPublishedSchedule() {
 std::vector<DbSchedule> ScheduleRepository::findSchedulesByUser(long userId) {
     std::vector<DbSchedule> result;
 
-    auto conn = factory_.createConnection();
+    auto conn = factory_.acquire();
     pqxx::work tx(*conn);
 
-    const char* sql = R"SQL(
-        SELECT
-            id,
-            user_id,
-            COALESCE(name, '')        AS name,
-            config_json::text         AS config_json,
-            result_json::text         AS result_json,
-            created_at,
-            updated_at,
-            is_public
-        FROM exam_schedule
-        WHERE user_id = $1
-        ORDER BY created_at DESC, id DESC;
-    )SQL";
-
-    pqxx::result rows = tx.exec_params(sql, userId);
+    pqxx::result rows = tx.exec_prepared(stmt::kFindSchedulesByUser, userId);
     tx.commit();
 
     for (const auto& r : rows) {
@@ -243,30 +497,43 @@ std::vector<DbSchedule> ScheduleRepository::findSchedulesByUser(long userId) {
     return result;
 }
 
+std::vector<DbScheduleSummary> ScheduleRepository::listScheduleSummaries(
+    long userId,
+    std::optional<long> afterId,
+    int limit
+) {
+    std::vector<DbScheduleSummary> result;
+
+    auto conn = factory_.acquire();
+    pqxx::work tx(*conn);
+
+    pqxx::result rows = tx.exec_prepared(stmt::kListScheduleSummaries, userId, afterId, limit);
+    tx.commit();
+
+    result.reserve(rows.size());
+    for (const auto& r : rows) {
+        DbScheduleSummary s;
+        s.id           = r["id"].as<long>();
+        s.name         = r["name"].as<std::string>();
+        s.createdAt    = r["created_at"].as<std::string>();
+        s.updatedAt    = r["updated_at"].as<std::string>();
+        s.isPublished  = r["is_public"].as<bool>(false);
+        s.examCount    = r["exam_count"].as<int>(0);
+        s.validationOk = r["validation_ok"].as<bool>(false);
+        result.push_back(std::move(s));
+    }
+
+    return result;
+}
+
 std::optional<DbSchedule> ScheduleRepository::findScheduleById(
     long userId,
     long scheduleId
 ) {
-    auto conn = factory_.createConnection();
+    auto conn = factory_.acquire();
     pqxx::work tx(*conn);
 
-    const char* sql = R"SQL(
-        SELECT
-            id,
-            user_id,
-            COALESCE(name, '')        AS name,
-            config_json::text         AS config_json,
-            result_json::text         AS result_json,
-            created_at,
-            updated_at,
-            is_public
-        FROM exam_schedule
-        WHERE id = $1
-          AND user_id = $2
-        LIMIT 1;
-    )SQL";
-
-    pqxx::result rows = tx.exec_params(sql, scheduleId, userId);
+    pqxx::result rows = tx.exec_prepared(stmt::kFindScheduleById, scheduleId, userId);
     tx.commit();
 
     if (rows.empty()) {
@@ -288,33 +555,106 @@ std::optional<DbSchedule> ScheduleRepository::findScheduleById(
     return s;
 }
 
+bool ScheduleRepository::updateSchedule(
+    long userId,
+    long scheduleId,
+    const std::string& configJson,
+    const std::string& resultJson
+) {
+    auto conn = factory_.acquire();
+    pqxx::work tx(*conn);
+
+    pqxx::result r = tx.exec_prepared(stmt::kUpdateSchedule, scheduleId, userId, configJson, resultJson);
+
+    if (r.empty()) {
+        tx.commit();
+        return false;
+    }
+
+    changed(tx, scheduleId);
+    return true;
+}
+
 bool ScheduleRepository::publishSchedule(long scheduleId) {
-    auto conn = factory_.createConnection();
+    auto conn = factory_.acquire();
     pqxx::work tx(*conn);
 
     // Сбрасываем флаг у всех
-    tx.exec("UPDATE exam_schedule SET is_public = FALSE");
+    tx.exec_prepared(stmt::kUnpublishAll);
 
     // Помечаем нужное расписание опубликованным
-    const char* sql = R"SQL(
-        UPDATE exam_schedule
-        SET is_public = TRUE,
-            published_at = NOW()
-        WHERE id = $1
-        RETURNING id;
-    )SQL";
-
-    pqxx::result r = tx.exec_params(sql, scheduleId);
+    pqxx::result r = tx.exec_prepared(stmt::kPublishSchedule, scheduleId);
 
     if (r.empty()) {
         tx.commit();
         return false; // такого расписания нет
     }
 
-    tx.commit();
+    changed(tx, scheduleId);
     return true;
 }
 
+void ScheduleRepository::changed(pqxx::work& tx, long scheduleId) {
+    // NOTIFY уходит подписчикам только при коммите транзакции
+    tx.exec_prepared(stmt::kNotify, kScheduleChangedChannel, std::to_string(scheduleId));
+    tx.commit();
+
+    if (onChange_) {
+        onChange_(scheduleId);
+    }
+}
+
+// ==================== ChangeListener ====================
+
+namespace {
+
+class ChannelReceiver : public pqxx::notification_receiver {
+public:
+    ChannelReceiver(pqxx::connection& conn, const std::string& channel, const ChangeListener::Callback& onNotify)
+        : pqxx::notification_receiver(conn, channel), onNotify_(onNotify) {}
+
+    void operator()(const std::string& payload, int /*backendPid*/) override {
+        onNotify_(payload);
+    }
+
+private:
+    const ChangeListener::Callback& onNotify_;
+};
+
+} // namespace
+
+ChangeListener::ChangeListener(ConnectionFactory& factory, std::string channel, Callback onNotify)
+    : factory_(factory), channel_(std::move(channel)), onNotify_(std::move(onNotify)) {
+    thread_ = std::thread([this] { run(); });
+}
+
+ChangeListener::~ChangeListener() {
+    stopping_.store(true);
+    thread_.join();
+}
+
+void ChangeListener::run() {
+    while (!stopping_.load()) {
+        try {
+            auto conn = factory_.createConnection();
+            ChannelReceiver receiver(*conn, channel_, onNotify_);
+            logInfo("LISTEN " + channel_ + ": подписка активна");
+            onNotify_("");
+
+            // ждём не больше секунды, чтобы вовремя заметить остановку
+            while (!stopping_.load()) {
+                conn->await_notification(1, 0);
+            }
+        } catch (const std::exception& ex) {
+            logWarning("LISTEN " + channel_ + ": соединение потеряно (" + ex.what() + "), переподключаемся");
+            onNotify_("");
+            for (int i = 0; i < 20 && !stopping_.load(); ++i) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+        }
+    }
+}
+
 // ==================== DomainData заглушки ====================
 
 std::vector<Group> loadGroups(ConnectionFactory& /*factory*/) {
@@ -2,9 +2,15 @@
 
 #include <pqxx/pqxx>
 
+#include <chrono>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <optional>
+#include <thread>
 #include <vector>
 
 #include "model.h"
@@ -28,18 +34,100 @@ struct DbConfig {
     std::string user;
     std::string password;
 
+    // пул соединений
+    int poolMin         = 1;     // открываются сразу при старте
+    int poolMax         = 8;     // больше одновременно не открываем
+    int poolWaitMs      = 5000;  // сколько ждать свободного соединения
+    int poolCheckIdleMs = 30000; // простоявшее дольше соединение проверяется SELECT 1
+
     static DbConfig fromEnv();
 };
 
-// --- Фабрика соединений ---
+// --- Имена подготовленных запросов; SQL к ним — в db.cpp (kPreparedStatements) ---
+namespace stmt {
+constexpr const char* kFindUserByUsername    = "find_user_by_username";
+constexpr const char* kCreateUser            = "create_user";
+constexpr const char* kCreateUserWithEmail   = "create_user_with_email";
+constexpr const char* kCreateSchedule        = "create_schedule";
+constexpr const char* kFindPublishedSchedule = "find_published_schedule";
+constexpr const char* kFindSchedulesByUser   = "find_schedules_by_user";
+constexpr const char* kListScheduleSummaries = "list_schedule_summaries";
+constexpr const char* kFindScheduleById      = "find_schedule_by_id";
+constexpr const char* kUpdateSchedule        = "update_schedule";
+constexpr const char* kUnpublishAll          = "unpublish_all";
+constexpr const char* kPublishSchedule       = "publish_schedule";
+constexpr const char* kLatestResult          = "latest_result";   // GET /api/public/schedule
+constexpr const char* kLatestSchedule        = "latest_schedule"; // GET /api/public/latest
+constexpr const char* kPing                  = "ping";            // GET /api/health/db
+constexpr const char* kNotify                = "notify";          // pg_notify($1, $2)
+} // namespace stmt
+
+// Канал NOTIFY: расписания созданы, изменены или опубликованы; payload — id расписания
+constexpr const char* kScheduleChangedChannel = "exam_schedule_changed";
+
+// Готовит на соединении все запросы из stmt (вызывается при его открытии);
+// запрос, который не удалось подготовить, пишется в лог и не мешает остальным
+void prepareStatements(pqxx::connection& conn);
+
+class ConnectionFactory;
+
+// --- Соединение, взятое из пула; в деструкторе возвращается обратно ---
+class PooledConnection {
+public:
+    PooledConnection(PooledConnection&& other) noexcept;
+    PooledConnection& operator=(PooledConnection&& other) noexcept;
+    ~PooledConnection();
+
+    PooledConnection(const PooledConnection&) = delete;
+    PooledConnection& operator=(const PooledConnection&) = delete;
+
+    pqxx::connection& operator*() const { return *conn_; }
+    pqxx::connection* operator->() const { return conn_.get(); }
+
+private:
+    friend class ConnectionFactory;
+    PooledConnection(ConnectionFactory* owner, std::unique_ptr<pqxx::connection> conn)
+        : owner_(owner), conn_(std::move(conn)) {}
+
+    void release();
+
+    ConnectionFactory* owner_;
+    std::unique_ptr<pqxx::connection> conn_;
+};
+
+// --- Фабрика соединений (она же пул) ---
 class ConnectionFactory {
 public:
     explicit ConnectionFactory(const DbConfig& cfg);
 
+    ConnectionFactory(const ConnectionFactory&) = delete;
+    ConnectionFactory& operator=(const ConnectionFactory&) = delete;
+
+    // Новое соединение в обход пула (запросы из stmt уже подготовлены)
     std::unique_ptr<pqxx::connection> createConnection() const;
 
+    // Соединение из пула: свободное (с проверкой, живо ли оно) или новое,
+    // если открыто меньше poolMax. Иначе ждёт до poolWaitMs и бросает
+    // std::runtime_error
+    PooledConnection acquire();
+
 private:
+    friend class PooledConnection;
+
+    struct IdleConnection {
+        std::unique_ptr<pqxx::connection> conn;
+        std::chrono::steady_clock::time_point since;
+    };
+
+    void giveBack(std::unique_ptr<pqxx::connection> conn);
+    bool healthy(pqxx::connection& conn, std::chrono::steady_clock::time_point idleSince) const;
+
     DbConfig config;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<IdleConnection> idle_;
+    int open_ = 0; // открыто соединений: свободные + выданные
 };
 
 // --- Репозиторий пользователей ---
@@ -70,6 +158,17 @@ struct DbSchedule {
     bool isPublished;
 };
 
+// --- Краткие сведения о расписании для списка, без config/result ---
+struct DbScheduleSummary {
+    long id;
+    std::string name;
+    std::string createdAt;
+    std::string updatedAt;
+    bool isPublished;
+    int examCount;      // экзаменов в сохранённом результате
+    bool validationOk;  // результат прошёл проверку без ошибок
+};
+
 // --- Репозиторий расписаний ---
 class ScheduleRepository {
 public:
@@ -88,14 +187,63 @@ public:
 
     std::vector<DbSchedule> findSchedulesByUser(long userId);
 
+    // Страница списка расписаний пользователя, новые первыми, не больше limit.
+    // afterId — id последнего расписания предыдущей страницы (продолжение
+    // по ключу (created_at, id), без OFFSET); nullopt — первая страница
+    std::vector<DbScheduleSummary> listScheduleSummaries(
+        long userId,
+        std::optional<long> afterId,
+        int limit
+    );
+
     // Одно расписание по id, только если принадлежит userId
     std::optional<DbSchedule> findScheduleById(long userId, long scheduleId);
 
+    // Перезаписать config и результат расписания; false, если нет такого id у userId
+    bool updateSchedule(
+        long userId,
+        long scheduleId,
+        const std::string& configJson,
+        const std::string& resultJson
+    );
+
     // Пометить расписание опубликованным (сбрасывает флаг у остальных)
     bool publishSchedule(long scheduleId);
 
+    // Вызывается с id расписания после каждого успешного create/update/publish
+    // в этом процессе. Другим экземплярам сервера те же изменения приходят через
+    // NOTIFY kScheduleChangedChannel (см. ChangeListener). Задавать до начала работы.
+    void setOnChange(std::function<void(long scheduleId)> onChange) { onChange_ = std::move(onChange); }
+
 private:
+    void changed(pqxx::work& tx, long scheduleId);
+
+    ConnectionFactory& factory_;
+    std::function<void(long scheduleId)> onChange_;
+};
+
+// --- Подписка на NOTIFY: свой поток и отдельное соединение вне пула ---
+// onNotify вызывается из потока подписки с payload каждого уведомления канала,
+// а также с пустым payload после (пере)подключения — пока соединения не было,
+// уведомления могли потеряться.
+class ChangeListener {
+public:
+    using Callback = std::function<void(const std::string& payload)>;
+
+    ChangeListener(ConnectionFactory& factory, std::string channel, Callback onNotify);
+    ~ChangeListener();
+
+    ChangeListener(const ChangeListener&) = delete;
+    ChangeListener& operator=(const ChangeListener&) = delete;
+
+private:
+    void run();
+
     ConnectionFactory& factory_;
+    std::string channel_;
+    Callback onNotify_;
+    std::atomic<bool> stopping_{false};
+    std::thread thread_;
 };
 
 // --- доменные данные (группы/преподы/предметы/аудитории/слоты/экзамены) ---
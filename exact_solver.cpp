@@ -0,0 +1,530 @@
+// exact_solver.cpp
+#include "exact_solver.h"
+
+#include "bitops.h"
+#include "graph.h"
+#include "instance_index.h"
+#include "logger.h"
+#include "validator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <unordered_map>
+
+const char* exactStatusName(ExactStatus status) {
+    switch (status) {
+        case ExactStatus::Solved: return "solved";
+        case ExactStatus::Infeasible: return "infeasible";
+        case ExactStatus::LimitReached: return "limit";
+        case ExactStatus::TooLarge: return "too_large";
+    }
+    return "limit";
+}
+
+namespace {
+
+// Почему значение удалено из домена
+enum class Reason : unsigned char {
+    Edge,     // сосед по графу конфликтов занял этот слот
+    GroupDay, // группа набрала maxPerDay экзаменов в этот день
+    Room,     // в слоте не осталось подходящей аудитории
+    Tried     // значение перебрано на своей глубине и не подошло
+};
+
+struct TrailEntry {
+    int exam;
+    int slot;
+    int depth;       // глубина, на которой сделано удаление
+    Reason reason;
+    int prevForExam; // предыдущая запись того же экзамена в trail_, -1 — нет
+};
+
+class ExactSearch {
+public:
+    ExactSearch(
+        const std::vector<Exam>& exams,
+        const InstanceIndex& index,
+        int maxPerDay,
+        const CsrConflictGraph& graph
+    )
+        : n_(exams.size()),
+          slotCount_(index.timeslots().size()),
+          dayCount_(index.dayCount()),
+          maxPerDay_(maxPerDay),
+          index_(index),
+          graph_(graph),
+          slotWords_(wordsForBits(slotCount_)),
+          depthWords_(wordsForBits(n_)),
+          group_(n_), size_(n_),
+          domains_((size_t)n_ * slotWords_, 0),
+          domainSize_(n_, slotCount_),
+          slot_(n_, -1), depthOf_(n_, -1), order_(n_, -1),
+          head_(n_, -1),
+          conf_((size_t)n_ * depthWords_, 0),
+          slotExams_(slotCount_), slotSizes_(slotCount_),
+          slotsOfDay_(dayCount_) {
+        std::unordered_map<int, int> extraGroups;
+        int groupCount = index.groups().size();
+        for (int i = 0; i < n_; ++i) {
+            int g = index.groupIndex(exams[i].groupId);
+            if (g < 0) g = extraGroups.emplace(exams[i].groupId, groupCount + (int)extraGroups.size()).first->second;
+            const Group* grp = index.findGroup(exams[i].groupId);
+            group_[i] = g;
+            size_[i] = grp ? grp->peopleCount : 0;
+        }
+        weight_.resize(n_);
+        for (int i = 0; i < n_; ++i) weight_[i] = 1 + graph.degree(i);
+        groupMembers_.resize(groupCount + extraGroups.size());
+        for (int i = 0; i < n_; ++i) groupMembers_[group_[i]].push_back(i);
+        groupDay_.assign(groupMembers_.size() * (size_t)dayCount_, 0);
+
+        for (int s = 0; s < slotCount_; ++s) slotsOfDay_[index.dayOfTimeslot(s)].push_back(s);
+
+        // домены: все слоты
+        for (int i = 0; i < n_; ++i) {
+            for (int s = 0; s < slotCount_; ++s) setBit(domain(i), s);
+        }
+
+        // аудитории без повторов id, по возрастанию вместимости
+        const std::vector<Room>& rooms = index.rooms();
+        for (int r = 0; r < (int)rooms.size(); ++r) {
+            if (index.roomIndex(rooms[r].id) == r) roomsAsc_.push_back(r);
+        }
+        std::stable_sort(roomsAsc_.begin(), roomsAsc_.end(),
+            [&](int a, int b) { return rooms[a].capacity < rooms[b].capacity; });
+        for (auto it = roomsAsc_.rbegin(); it != roomsAsc_.rend(); ++it) {
+            capacitiesDesc_.push_back(rooms[*it].capacity);
+        }
+
+        trail_.reserve((size_t)n_ * slotCount_);
+    }
+
+    ExactStatus run(const ExactSolverOptions& options, ExactSolverResult& result) {
+        using Clock = std::chrono::steady_clock;
+        auto deadline = Clock::now() + std::chrono::milliseconds(std::max(0, options.timeLimitMs));
+        std::vector<uint64_t> explanation(depthWords_);
+
+        int depth = 0;
+        bool fresh = true;
+        while (true) {
+            if (depth == n_) return ExactStatus::Solved;
+
+            if (fresh) {
+                order_[depth] = pickVariable();
+                std::fill(conf(depth), conf(depth) + depthWords_, 0);
+                fresh = false;
+            }
+            int v = order_[depth];
+
+            bool placed = false;
+            while (domainSize_[v] > 0) {
+                if ((result.nodes & 255) == 0 &&
+                    (Clock::now() >= deadline ||
+                     (options.cancel && options.cancel->load(std::memory_order_relaxed)))) {
+                    return ExactStatus::LimitReached;
+                }
+                if (options.nodeLimit > 0 && result.nodes >= options.nodeLimit) return ExactStatus::LimitReached;
+                ++result.nodes;
+
+                int s = firstValue(v);
+
+                // аудитории слота: вина на экзаменах, уже стоящих в нём
+                if (!roomsFit(v, s)) {
+                    for (int e : slotExams_[s]) setBit(conf(depth), depthOf_[e]);
+                    removeValue(v, s, depth, Reason::Tried);
+                    continue;
+                }
+
+                int wiped = assign(v, s, depth);
+                if (wiped < 0) {
+                    placed = true;
+                    break;
+                }
+
+                // у будущего экзамена не осталось слотов — запоминаем, кто их отнял
+                ++weight_[wiped];
+                explain(wiped, conf(depth));
+                clearBit(conf(depth), depth);
+                undoForward(depth);
+                unassign(v);
+                removeValue(v, s, depth, Reason::Tried);
+            }
+
+            if (placed) {
+                ++depth;
+                fresh = true;
+                continue;
+            }
+
+            // все значения v перебраны: прыгаем к самой глубокой виновной переменной
+            ++weight_[v];
+            std::copy(conf(depth), conf(depth) + depthWords_, explanation.begin());
+            explain(v, explanation.data());
+
+            int h = highestBit(explanation.data());
+            if (h < 0) return ExactStatus::Infeasible;
+            ++result.backjumps;
+
+            clearBit(explanation.data(), h);
+            for (int w = 0; w < depthWords_; ++w) conf(h)[w] |= explanation[w];
+
+            int failedVar = order_[h];
+            int failedSlot = slot_[failedVar];
+            for (int k = depth - 1; k >= h; --k) unassign(order_[k]);
+            undoAbove(h);
+            undoForward(h);
+            removeValue(failedVar, failedSlot, h, Reason::Tried);
+
+            depth = h;
+        }
+    }
+
+    // Итоговые назначения: в каждом слоте экзамены по убыванию размера
+    // получают наименьшую свободную подходящую аудиторию
+    std::vector<ExamAssignment> buildAssignments() const {
+        const std::vector<Timeslot>& timeslots = index_.timeslots();
+        const std::vector<Room>& rooms = index_.rooms();
+
+        std::vector<int> roomOf(n_, -1);
+        std::vector<char> used(roomsAsc_.size());
+        for (int s = 0; s < slotCount_; ++s) {
+            std::vector<int> examsInSlot = slotExams_[s];
+            std::stable_sort(examsInSlot.begin(), examsInSlot.end(),
+                [&](int a, int b) { return size_[a] > size_[b]; });
+            std::fill(used.begin(), used.end(), 0);
+            for (int e : examsInSlot) {
+                for (int k = 0; k < (int)roomsAsc_.size(); ++k) {
+                    if (used[k] || rooms[roomsAsc_[k]].capacity < size_[e]) continue;
+                    used[k] = 1;
+                    roomOf[e] = roomsAsc_[k];
+                    break;
+                }
+            }
+        }
+
+        std::vector<ExamAssignment> assignments;
+        assignments.reserve(n_);
+        for (int i = 0; i < n_; ++i) {
+            assignments.push_back({i, timeslots[slot_[i]].id, roomOf[i] >= 0 ? rooms[roomOf[i]].id : -1});
+        }
+        return assignments;
+    }
+
+private:
+    uint64_t* domain(int exam) { return domains_.data() + (size_t)exam * slotWords_; }
+    const uint64_t* domain(int exam) const { return domains_.data() + (size_t)exam * slotWords_; }
+    uint64_t* conf(int depth) { return conf_.data() + (size_t)depth * depthWords_; }
+
+    int firstValue(int exam) const {
+        const uint64_t* d = domain(exam);
+        for (int w = 0; w < slotWords_; ++w) {
+            if (d[w]) return w * kWordBits + ctz64(d[w]);
+        }
+        return -1;
+    }
+
+    int highestBit(const uint64_t* bits) const {
+        for (int w = depthWords_ - 1; w >= 0; --w) {
+            if (bits[w]) return w * kWordBits + msb64(bits[w]);
+        }
+        return -1;
+    }
+
+    // dom/wdeg: наименьшее отношение размера домена к весу экзамена
+    int pickVariable() const {
+        int best = -1;
+        for (int i = 0; i < n_; ++i) {
+            if (depthOf_[i] >= 0) continue;
+            // domainSize_[i] / weight_[i] < domainSize_[best] / weight_[best]
+            if (best < 0 ||
+                (long long)domainSize_[i] * weight_[best] < (long long)domainSize_[best] * weight_[i]) {
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    void removeValue(int exam, int slot, int depth, Reason reason) {
+        clearBit(domain(exam), slot);
+        --domainSize_[exam];
+        trail_.push_back({exam, slot, depth, reason, head_[exam]});
+        head_[exam] = trail_.size() - 1;
+    }
+
+    void popTrail() {
+        const TrailEntry& t = trail_.back();
+        setBit(domain(t.exam), t.slot);
+        ++domainSize_[t.exam];
+        head_[t.exam] = t.prevForExam;
+        trail_.pop_back();
+    }
+
+    // Откат всех удалений, сделанных глубже depth
+    void undoAbove(int depth) {
+        while (!trail_.empty() && trail_.back().depth > depth) popTrail();
+    }
+
+    // Откат проверки вперёд, сделанной на глубине depth (перебранные значения остаются)
+    void undoForward(int depth) {
+        while (!trail_.empty() &&
+               (trail_.back().depth > depth ||
+                (trail_.back().depth == depth && trail_.back().reason != Reason::Tried))) {
+            popTrail();
+        }
+    }
+
+    // Хватит ли аудиторий слота s, если добавить в него экзамен v:
+    // k-й по размеру экзамен должен помещаться в k-ю по вместимости аудиторию
+    bool roomsFit(int v, int s) const {
+        const std::vector<int>& sizes = slotSizes_[s]; // по убыванию
+        int k = sizes.size();
+        if (k + 1 > (int)capacitiesDesc_.size()) return false;
+
+        int x = size_[v];
+        bool inserted = false;
+        int pos = 0;
+        for (int i = 0; i < k || !inserted; ++pos) {
+            int cur;
+            if (!inserted && (i == k || x >= sizes[i])) {
+                cur = x;
+                inserted = true;
+            } else {
+                cur = sizes[i++];
+            }
+            if (cur > capacitiesDesc_[pos]) return false;
+        }
+        return true;
+    }
+
+    // Ставит v в слот s и отсекает слот у соседей и день у группы, если она набрала maxPerDay.
+    // Возвращает экзамен, домен которого опустел, или -1
+    int assign(int v, int s, int depth) {
+        slot_[v] = s;
+        depthOf_[v] = depth;
+        slotExams_[s].push_back(v);
+        std::vector<int>& sizes = slotSizes_[s];
+        sizes.insert(std::upper_bound(sizes.begin(), sizes.end(), size_[v], std::greater<int>()), size_[v]);
+
+        // счётчик (группа, день) — до отсечений: они могут выйти раньше,
+        // а unassign снимает его всегда
+        int day = index_.dayOfTimeslot(s);
+        int dayCount = 0;
+        if (maxPerDay_ > 0) dayCount = ++groupDay_[(size_t)group_[v] * dayCount_ + day];
+
+        for (const int* it = graph_.begin(v); it != graph_.end(v); ++it) {
+            int j = *it;
+            if (depthOf_[j] >= 0 || !testBit(domain(j), s)) continue;
+            removeValue(j, s, depth, Reason::Edge);
+            if (domainSize_[j] == 0) return j;
+        }
+
+        // аудитории слота s: у кого из будущих экзаменов он больше не помещается
+        for (int j = 0; j < n_; ++j) {
+            if (depthOf_[j] >= 0 || !testBit(domain(j), s) || roomsFit(j, s)) continue;
+            removeValue(j, s, depth, Reason::Room);
+            if (domainSize_[j] == 0) return j;
+        }
+
+        if (maxPerDay_ > 0 && dayCount == maxPerDay_) {
+            for (int j : groupMembers_[group_[v]]) {
+                if (depthOf_[j] >= 0) continue;
+                for (int t : slotsOfDay_[day]) {
+                    if (!testBit(domain(j), t)) continue;
+                    removeValue(j, t, depth, Reason::GroupDay);
+                }
+                if (domainSize_[j] == 0) return j;
+            }
+        }
+        return -1;
+    }
+
+    // Снимает v (только в порядке, обратном assign); домены откатываются отдельно
+    void unassign(int v) {
+        int s = slot_[v];
+        slotExams_[s].pop_back();
+        std::vector<int>& sizes = slotSizes_[s];
+        sizes.erase(std::find(sizes.begin(), sizes.end(), size_[v]));
+        if (maxPerDay_ > 0) --groupDay_[(size_t)group_[v] * dayCount_ + index_.dayOfTimeslot(s)];
+        slot_[v] = -1;
+        depthOf_[v] = -1;
+    }
+
+    // Глубины назначений, из-за которых из домена exam удалены значения (кроме перебранных).
+    // Назначения, сделанные позже удаления, в объяснение не входят
+    void explain(int exam, uint64_t* out) const {
+        for (int e = head_[exam]; e >= 0; e = trail_[e].prevForExam) {
+            const TrailEntry& t = trail_[e];
+            if (t.reason == Reason::Edge) {
+                setBit(out, t.depth);
+            } else if (t.reason == Reason::GroupDay) {
+                int day = index_.dayOfTimeslot(t.slot);
+                for (int m : groupMembers_[group_[exam]]) {
+                    if (depthOf_[m] >= 0 && depthOf_[m] <= t.depth &&
+                        index_.dayOfTimeslot(slot_[m]) == day) setBit(out, depthOf_[m]);
+                }
+            } else if (t.reason == Reason::Room) {
+                for (int m : slotExams_[t.slot]) {
+                    if (depthOf_[m] <= t.depth) setBit(out, depthOf_[m]);
+                }
+            }
+        }
+    }
+
+    int n_;
+    int slotCount_;
+    int dayCount_;
+    int maxPerDay_;
+    const InstanceIndex& index_;
+    const CsrConflictGraph& graph_;
+    int slotWords_;
+    int depthWords_;
+
+    std::vector<int> group_, size_;
+    std::vector<std::vector<int>> groupMembers_;
+
+    BitWords domains_;             // n_ * slotWords_
+    std::vector<int> domainSize_;
+    std::vector<int> slot_, depthOf_, order_;
+    std::vector<long long> weight_; // степень + число тупиков с участием экзамена
+
+    std::vector<TrailEntry> trail_;
+    std::vector<int> head_;        // последняя запись trail_ по экзамену
+    std::vector<uint64_t> conf_;   // множества конфликтов по глубинам, n_ * depthWords_
+
+    std::vector<std::vector<int>> slotExams_;
+    std::vector<std::vector<int>> slotSizes_;
+    std::vector<int> groupDay_;
+    std::vector<std::vector<int>> slotsOfDay_;
+
+    std::vector<int> roomsAsc_;
+    std::vector<int> capacitiesDesc_;
+};
+
+// Необходимые условия, которые проверяются подсчётом: экзаменов группы или
+// преподавателя не больше слотов (и не больше maxPerDay * дней), экзаменов с
+// размером >= x не больше (аудиторий вместимостью >= x) * слотов.
+// Возвращает описание нарушенного условия или пустую строку
+static std::string findCountingObstacle(
+    const std::vector<Exam>& exams,
+    const InstanceIndex& index,
+    int maxPerDay
+) {
+    long long slotCount = index.timeslots().size();
+
+    std::unordered_map<int, long long> perGroup, perTeacher;
+    for (const Exam& e : exams) {
+        perGroup[e.groupId]++;
+        perTeacher[e.teacherId]++;
+    }
+    for (const auto& p : perGroup) {
+        if (p.second > slotCount) {
+            return "у группы id=" + std::to_string(p.first) + " экзаменов (" + std::to_string(p.second) +
+                   ") больше, чем слотов (" + std::to_string(slotCount) + ")";
+        }
+        if (maxPerDay > 0 && p.second > (long long)maxPerDay * index.dayCount()) {
+            return "у группы id=" + std::to_string(p.first) + " экзаменов (" + std::to_string(p.second) +
+                   ") больше, чем maxPerDay * дней (" + std::to_string((long long)maxPerDay * index.dayCount()) + ")";
+        }
+    }
+    for (const auto& p : perTeacher) {
+        if (p.second > slotCount) {
+            return "у преподавателя id=" + std::to_string(p.first) + " экзаменов (" + std::to_string(p.second) +
+                   ") больше, чем слотов (" + std::to_string(slotCount) + ")";
+        }
+    }
+
+    std::vector<int> sizes;
+    sizes.reserve(exams.size());
+    for (const Exam& e : exams) {
+        const Group* g = index.findGroup(e.groupId);
+        sizes.push_back(g ? g->peopleCount : 0);
+    }
+    std::vector<int> capacities;
+    const std::vector<Room>& rooms = index.rooms();
+    for (int r = 0; r < (int)rooms.size(); ++r) {
+        if (index.roomIndex(rooms[r].id) == r) capacities.push_back(rooms[r].capacity);
+    }
+    std::sort(sizes.begin(), sizes.end(), std::greater<int>());
+    std::sort(capacities.begin(), capacities.end(), std::greater<int>());
+
+    size_t fitting = 0; // аудиторий вместимостью >= sizes[k]
+    for (size_t k = 0; k < sizes.size(); ++k) {
+        while (fitting < capacities.size() && capacities[fitting] >= sizes[k]) ++fitting;
+        if ((long long)(k + 1) > (long long)fitting * slotCount) {
+            return "экзаменов на " + std::to_string(sizes[k]) + "+ человек (" + std::to_string(k + 1) +
+                   ") больше, чем мест в подходящих аудиториях по всем слотам (" +
+                   std::to_string((long long)fitting * slotCount) + ")";
+        }
+    }
+    return "";
+}
+
+} // namespace
+
+ExactSolverResult solveExact(
+    const std::vector<Exam>& exams,
+    const InstanceIndex& index,
+    int maxExamsPerDayForGroup,
+    const ExactSolverOptions& options
+) {
+    using Clock = std::chrono::steady_clock;
+    auto startTime = Clock::now();
+
+    ExactSolverResult result;
+    int n = exams.size();
+
+    if (n > options.maxExams) {
+        result.status = ExactStatus::TooLarge;
+        LOG_WARN("Точный поиск: экзаменов " + std::to_string(n) +
+                 " > " + std::to_string(options.maxExams) + ", не запускаем");
+        return result;
+    }
+    if (n == 0) {
+        result.status = ExactStatus::Solved;
+        return result;
+    }
+    if (index.timeslots().empty()) {
+        result.status = ExactStatus::Infeasible;
+        result.infeasibleReason = "нет ни одного слота";
+        LOG_WARN("Точный поиск: нет ни одного слота");
+        return result;
+    }
+
+    result.infeasibleReason = findCountingObstacle(exams, index, maxExamsPerDayForGroup);
+    if (!result.infeasibleReason.empty()) {
+        result.status = ExactStatus::Infeasible;
+        LOG_INFO("Точный поиск: infeasible без перебора — " + result.infeasibleReason);
+        return result;
+    }
+
+    CsrConflictGraph graph = buildCsrConflictGraph(exams);
+    ExactSearch search(exams, index, maxExamsPerDayForGroup, graph);
+
+    result.status = search.run(options, result);
+    if (result.status == ExactStatus::Solved) {
+        result.assignments = search.buildAssignments();
+
+        // Solved обещает расписание без нарушений — сверяем с валидатором
+        // (границы сессии тут ни при чём: берём первый и последний день слотов)
+        ScheduleValidator validator;
+        ValidationResult check = validator.checkAll(
+            exams, index, result.assignments,
+            index.dayDate(0), index.dayDate(index.dayCount() - 1),
+            maxExamsPerDayForGroup);
+        if (!check.ok) {
+            LOG_ERROR("Точный поиск: найденное расписание не прошло проверку (ошибок=" +
+                      std::to_string(check.errorCount()) + "), считаем, что ответа нет");
+            result.status = ExactStatus::LimitReached;
+            result.assignments.clear();
+        }
+    }
+    result.elapsedMs = std::chrono::duration<double, std::milli>(Clock::now() - startTime).count();
+
+    LOG_INFO(std::string("Точный поиск: ") + exactStatusName(result.status) +
+             ", узлов=" + std::to_string(result.nodes) +
+             ", возвратов=" + std::to_string(result.backjumps) +
+             ", время=" + std::to_string((long long)result.elapsedMs) + " мс");
+    return result;
+}
@@ -0,0 +1,52 @@
+// exact_solver.h — точный поиск с возвратами (FC-CBJ) для небольших сессий
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include "model.h"
+
+class InstanceIndex;
+
+// Больше этого числа экзаменов точный поиск не запускаем
+constexpr int kExactMaxExams = 300;
+
+enum class ExactStatus {
+    Solved,       // найдено расписание без нарушений (сверено с ScheduleValidator::checkAll)
+    Infeasible,   // доказано, что расписания без нарушений не существует
+    LimitReached, // исчерпан лимит времени или узлов, ответа нет
+    TooLarge      // экзаменов больше maxExams, поиск не запускался
+};
+
+struct ExactSolverOptions {
+    int timeLimitMs = 5000;
+    long long nodeLimit = 0;     // 0 — без ограничения
+    int maxExams = kExactMaxExams;
+    const std::atomic<bool>* cancel = nullptr; // true — прервать (статус LimitReached)
+};
+
+struct ExactSolverResult {
+    ExactStatus status = ExactStatus::LimitReached;
+    std::vector<ExamAssignment> assignments; // только при Solved, по одному на экзамен в порядке exams
+    long long nodes = 0;       // попыток поставить экзамен в слот
+    long long backjumps = 0;
+    double elapsedMs = 0.0;
+    std::string infeasibleReason; // для Infeasible, найденного подсчётом; пусто — доказано перебором
+};
+
+// "solved" / "infeasible" / "limit" / "too_large"
+const char* exactStatusName(ExactStatus status);
+
+// Поиск назначения (экзамен -> слот, аудитория) без конфликтов групп и преподавателей,
+// с аудиториями подходящей вместимости без накладок и с не более maxExamsPerDayForGroup
+// экзаменами группы в день (0 — без ограничения).
+// Домены слотов — битовые множества, после каждого назначения — проверка вперёд
+// (forward checking), при тупике — возврат сразу к виновной переменной
+// (conflict-directed backjumping). Переменная — с наименьшим отношением размера
+// домена к весу (степень + число тупиков с её участием, dom/wdeg).
+ExactSolverResult solveExact(
+    const std::vector<Exam>& exams,
+    const InstanceIndex& index,
+    int maxExamsPerDayForGroup,
+    const ExactSolverOptions& options = ExactSolverOptions()
+);
@@ -2,99 +2,210 @@
 #include "generator.h"
 
 #include "graph.h"
+#include "exact_solver.h"
 #include "logger.h"
 #include "api_dto.h"
+#include "instance_index.h"
 
-#include <map>
+#include <unordered_map>
 #include <algorithm>
+#include <random>
 #include <string>
 
 // --- маленькие хелперы ---
 
-static const Subject* findSubjectById(
-    const std::vector<Subject>& subjects,
-    int subjectId
-) {
-    for (const Subject& s : subjects) {
-        if (s.id == subjectId) return &s;
-    }
-    return nullptr;
-}
-
 static int getExamDifficulty(
     const Exam& exam,
-    const std::vector<Subject>& subjects
+    const InstanceIndex& index
 ) {
-    const Subject* s = findSubjectById(subjects, exam.subjectId);
+    const Subject* s = index.findSubject(exam.subjectId);
     if (!s) return 1; // по умолчанию сложность 1
     return s->difficulty;
 }
 
-static const Group* findGroupByIdForScheduler(
-    const std::vector<Group>& groups,
-    int groupId
-) {
-    for (const Group& g : groups) {
-        if (g.id == groupId) return &g;
+// Счётчики экзаменов по (группа, день), поддерживаются инкрементально по мере
+// назначения — проверка maxExamsPerDayForGroup за O(1) вместо обхода всех назначений.
+class GroupDayCounters {
+public:
+    GroupDayCounters(
+        const std::vector<Exam>& exams,
+        const InstanceIndex& index,
+        int maxExamsPerDayForGroup
+    )
+        : index_(index),
+          maxPerDay_(maxExamsPerDayForGroup),
+          dayCount_(index.dayCount()),
+          examGroup_(exams.size()) {
+        // плотный ключ группы: индекс в groups, группы вне списка — после них
+        std::unordered_map<int, int> unknownGroups;
+        int groupCount = index.groups().size();
+        for (int i = 0; i < (int)exams.size(); ++i) {
+            int g = index.groupIndex(exams[i].groupId);
+            if (g < 0) {
+                auto it = unknownGroups.emplace(exams[i].groupId, groupCount + (int)unknownGroups.size()).first;
+                g = it->second;
+            }
+            examGroup_[i] = g;
+        }
+        counts_.assign((size_t)(groupCount + unknownGroups.size()) * dayCount_, 0);
     }
-    return nullptr;
-}
 
-static const Timeslot* findTimeslotById(
-    const std::vector<Timeslot>& timeslots,
-    int timeslotId
-) {
-    for (const Timeslot& t : timeslots) {
-        if (t.id == timeslotId) return &t;
+    // Проверяем, не превышает ли экзамен ограничение maxExamsPerDayForGroup
+    // для своей группы в день слота timeslotId.
+    bool canPlace(int examIndex, int timeslotId) const {
+        if (maxPerDay_ <= 0) {
+            // 0 или отрицательное значение — трактуем как "без ограничения"
+            return true;
+        }
+        int cell = cellOf(examIndex, timeslotId);
+        if (cell < 0) {
+            // Если вдруг нет слота — пусть этим займётся валидатор
+            return true;
+        }
+        return counts_[cell] < maxPerDay_;
     }
-    return nullptr;
-}
 
-// Проверяем, не превышает ли экзамен ограничение maxExamsPerDayForGroup
-// для своей группы в день timeslotId.
-static bool canPlaceExamForGroupOnDate(
-    const Exam& exam,
-    int examIndex,
-    int candidateTimeslotId,
-    const std::vector<ExamAssignment>& assignments,
-    const std::vector<Exam>& exams,
-    const std::vector<Timeslot>& timeslots,
-    int maxExamsPerDayForGroup
-) {
-    if (maxExamsPerDayForGroup <= 0) {
-        // 0 или отрицательное значение — трактуем как "без ограничения"
-        return true;
+    void add(int examIndex, int timeslotId) {
+        int cell = cellOf(examIndex, timeslotId);
+        if (cell >= 0) counts_[cell]++;
     }
 
-    const Timeslot* tsCandidate = findTimeslotById(timeslots, candidateTimeslotId);
-    if (!tsCandidate) {
-        // Если вдруг нет слота — пусть этим займётся валидатор
-        return true;
+private:
+    int cellOf(int examIndex, int timeslotId) const {
+        int ts = index_.timeslotIndex(timeslotId);
+        if (ts < 0) return -1;
+        return examGroup_[examIndex] * dayCount_ + index_.dayOfTimeslot(ts);
     }
-    const std::string& day = tsCandidate->date;
 
-    int countForGroupThisDay = 0;
+    const InstanceIndex& index_;
+    int maxPerDay_;
+    int dayCount_;
+    std::vector<int> examGroup_;
+    std::vector<int> counts_;
+};
+
+// Занятость слотов: для каждого слота битовое множество экзаменов, которые идут
+// в его время — поставленных в него самого и в пересекающиеся с ним слоты.
+// "Есть ли в слоте сосед" — проверка битов соседей из CSR-графа, O(степень);
+// плотная матрица смежности для этого не нужна.
+class SlotOccupancy {
+public:
+    SlotOccupancy(const CsrConflictGraph& g, const InstanceIndex& index)
+        : g_(g),
+          index_(index),
+          words_(wordsForBits(g.n)),
+          exams_((size_t)index.timeslots().size() * words_, 0) {}
+
+    bool hasNeighborIn(int examIndex, int tsIndex) const {
+        const uint64_t* slot = exams_.data() + (size_t)tsIndex * words_;
+        for (const int* it = g_.begin(examIndex); it != g_.end(examIndex); ++it) {
+            if (testBit(slot, *it)) return true;
+        }
+        return false;
+    }
+
+    void placeExam(int tsIndex, int examIndex) {
+        setBit(exams_.data() + (size_t)tsIndex * words_, examIndex);
+        for (int other : index_.overlappingTimeslots(tsIndex)) {
+            setBit(exams_.data() + (size_t)other * words_, examIndex);
+        }
+    }
 
-    for (const ExamAssignment& a : assignments) {
-        if (a.timeslotId < 0) continue;
+private:
+    const CsrConflictGraph& g_;
+    const InstanceIndex& index_;
+    int words_;
+    BitWords exams_;
+};
+
+// Аудитории, упорядоченные по вместимости, и по каждому слоту битовая карта занятых
+// (в том числе экзаменами пересекающихся с ним слотов).
+// Наименьшая свободная аудитория не меньше группы (best fit): двоичный поиск
+// по вместимостям за O(log R), затем пословный поиск первого свободного бита —
+// в худшем случае (все подходящие заняты) O(R/64) слов, итого O(log R + R/64).
+class RoomPicker {
+public:
+    // rng != nullptr — аудитории одинаковой вместимости перемешиваются (варианты мультистарта)
+    RoomPicker(const InstanceIndex& index, std::mt19937* rng) : index_(index) {
+        const std::vector<Room>& rooms = index.rooms();
+        for (int k = 0; k < (int)rooms.size(); ++k) {
+            // аудитории с повторяющимся id — одна и та же аудитория
+            if (index.roomIndex(rooms[k].id) == k) sorted_.push_back(&rooms[k]);
+        }
+        if (rng) std::shuffle(sorted_.begin(), sorted_.end(), *rng);
+        std::stable_sort(sorted_.begin(), sorted_.end(),
+            [](const Room* a, const Room* b) { return a->capacity < b->capacity; });
 
-        const Timeslot* ts = findTimeslotById(timeslots, a.timeslotId);
-        if (!ts) continue;
-        if (ts->date != day) continue;
+        capacities_.reserve(sorted_.size());
+        for (const Room* r : sorted_) capacities_.push_back(r->capacity);
 
-        int otherIndex = a.examIndex;
-        if (otherIndex < 0 || otherIndex >= (int)exams.size()) continue;
-        const Exam& otherExam = exams[otherIndex];
+        words_ = wordsForBits(sorted_.size());
+        used_.assign((size_t)index.timeslots().size() * words_, 0);
+    }
 
-        if (otherExam.groupId == exam.groupId) {
-            countForGroupThisDay++;
-            if (countForGroupThisDay >= maxExamsPerDayForGroup) {
-                return false;
+    // Позиция наименьшей свободной аудитории вместимостью >= required, -1 если нет
+    int findBestFit(int tsIndex, int required) const {
+        int p = std::lower_bound(capacities_.begin(), capacities_.end(), required) - capacities_.begin();
+        if (p >= (int)sorted_.size()) return -1;
+
+        const uint64_t* used = used_.data() + (size_t)tsIndex * words_;
+        int w = p / kWordBits;
+        uint64_t freeBits = ~used[w] & (~0ULL << (p % kWordBits));
+        while (true) {
+            if (freeBits) {
+                int pos = w * kWordBits + ctz64(freeBits);
+                return pos < (int)sorted_.size() ? pos : -1;
             }
+            if (++w >= words_) return -1;
+            freeBits = ~used[w];
+        }
+    }
+
+    const Room& room(int pos) const { return *sorted_[pos]; }
+
+    void use(int tsIndex, int pos) {
+        setBit(used_.data() + (size_t)tsIndex * words_, pos);
+        for (int other : index_.overlappingTimeslots(tsIndex)) {
+            setBit(used_.data() + (size_t)other * words_, pos);
         }
     }
 
-    return true;
+private:
+    const InstanceIndex& index_;
+    std::vector<const Room*> sorted_;
+    std::vector<int> capacities_;
+    int words_ = 0;
+    BitWords used_;
+};
+
+bool parseColoringAlgorithm(const std::string& name, ColoringAlgorithm& out) {
+    if (name == "graph") {
+        out = ColoringAlgorithm::Greedy;
+        return true;
+    }
+    if (name == "dsatur") {
+        out = ColoringAlgorithm::Dsatur;
+        return true;
+    }
+    if (name == "parallel") {
+        out = ColoringAlgorithm::Parallel;
+        return true;
+    }
+    if (name == "exact") {
+        out = ColoringAlgorithm::Exact;
+        return true;
+    }
+    return false;
+}
+
+std::string coloringAlgorithmName(ColoringAlgorithm algorithm) {
+    switch (algorithm) {
+        case ColoringAlgorithm::Greedy: return "graph";
+        case ColoringAlgorithm::Dsatur: return "dsatur";
+        case ColoringAlgorithm::Parallel: return "parallel";
+        case ColoringAlgorithm::Exact: return "exact";
+    }
+    return "graph";
 }
 
 // ============================================================================
@@ -107,41 +218,120 @@ std::vector<ExamAssignment> generateSchedule(
     const std::vector<Subject>& subjects,
     const std::vector<Timeslot>& timeslots,
     const std::vector<Room>& rooms,
-    int maxExamsPerDayForGroup
+    int maxExamsPerDayForGroup,
+    const GeneratorOptions& options
+) {
+    static const std::vector<Teacher> noTeachers;
+    InstanceIndex index(groups, noTeachers, subjects, rooms, timeslots);
+    return generateSchedule(exams, index, maxExamsPerDayForGroup, options);
+}
+
+std::vector<ExamAssignment> generateScheduleExact(
+    const std::vector<Exam>& exams,
+    const InstanceIndex& index,
+    int maxExamsPerDayForGroup,
+    const GeneratorOptions& options,
+    ExactSolverResult& exact
+) {
+    // Точный поиск: найденное решение и есть результат, иначе — обычный путь через DSATUR
+    ExactSolverOptions exactOptions;
+    exactOptions.timeLimitMs = options.exactTimeLimitMs;
+    exactOptions.cancel = options.cancel;
+    exact = solveExact(exams, index, maxExamsPerDayForGroup, exactOptions);
+    if (exact.status == ExactStatus::Solved) return std::move(exact.assignments);
+
+    LOG_WARN(std::string("Точный поиск не дал расписания (") + exactStatusName(exact.status) +
+             "), строим жадно через dsatur");
+    GeneratorOptions fallback = options;
+    fallback.coloring = ColoringAlgorithm::Dsatur;
+    return generateSchedule(exams, index, maxExamsPerDayForGroup, fallback);
+}
+
+std::vector<ExamAssignment> generateSchedule(
+    const std::vector<Exam>& exams,
+    const InstanceIndex& index,
+    int maxExamsPerDayForGroup,
+    const GeneratorOptions& options
 ) {
-    logInfo("=== Запуск генерации расписания ===");
-    logInfo("Экзаменов: " + std::to_string(exams.size()) +
-            ", групп: " + std::to_string(groups.size()) +
-            ", слотов: " + std::to_string(timeslots.size()) +
-            ", аудиторий: " + std::to_string(rooms.size()));
+    if (options.coloring == ColoringAlgorithm::Exact) {
+        ExactSolverResult exact;
+        return generateScheduleExact(exams, index, maxExamsPerDayForGroup, options, exact);
+    }
+
+    const std::vector<Group>& groups       = index.groups();
+    const std::vector<Timeslot>& timeslots = index.timeslots();
+    const std::vector<Room>& rooms         = index.rooms();
+
+    LOG_INFO("=== Запуск генерации расписания (" +
+             coloringAlgorithmName(options.coloring) + ") ===");
+    LOG_INFO("Экзаменов: " + std::to_string(exams.size()) +
+             ", групп: " + std::to_string(groups.size()) +
+             ", слотов: " + std::to_string(timeslots.size()) +
+             ", аудиторий: " + std::to_string(rooms.size()));
 
     std::vector<ExamAssignment> assignments;
 
     if (exams.empty()) {
-        logWarning("Список экзаменов пуст. Расписание не будет сгенерировано.");
+        LOG_WARN("Список экзаменов пуст. Расписание не будет сгенерировано.");
         return assignments;
     }
     if (timeslots.empty()) {
-        logWarning("Список таймслотов пуст. Расписание не будет сгенерировано.");
+        LOG_WARN("Список таймслотов пуст. Расписание не будет сгенерировано.");
         return assignments;
     }
 
-    // 1) Граф конфликтов и раскраска
-    ConflictGraph g = buildConflictGraph(exams);
-    std::vector<int> colors = greedyColoring(g);
     int n = (int)exams.size();
 
+    // Вариант мультистарта: случайные порядок вершин, разрешение равенств и порядок аудиторий
+    bool shuffled = options.shuffleSeed != 0;
+    std::mt19937 rng(options.shuffleSeed);
+    std::vector<int> vertexOrder(n);
+    for (int i = 0; i < n; ++i) vertexOrder[i] = i;
+    if (shuffled) std::shuffle(vertexOrder.begin(), vertexOrder.end(), rng);
+
+    // 1) Граф конфликтов и раскраска
+    //    (готовый из options — общий для вариантов мультистарта, только чтение).
+    //    Плотная матрица (n^2 бит) нужна только жадной раскраске, остальным — CSR
+    CsrConflictGraph ownCsr;
+    if (!options.csr) ownCsr = buildCsrConflictGraph(exams);
+    const CsrConflictGraph& csr = options.csr ? *options.csr : ownCsr;
+
+    std::vector<int> colors;
+    switch (options.coloring) {
+        case ColoringAlgorithm::Dsatur:
+        case ColoringAlgorithm::Exact: {
+            std::vector<int> tieRank(n);
+            for (int i = 0; i < n; ++i) tieRank[vertexOrder[i]] = i;
+            colors = dsaturColoring(csr, tieRank);
+            break;
+        }
+        case ColoringAlgorithm::Parallel:
+            colors = jonesPlassmannColoring(
+                csr, shuffled ? options.seed ^ options.shuffleSeed : options.seed, options.threads);
+            break;
+        case ColoringAlgorithm::Greedy:
+        default:
+            if (options.graph) {
+                colors = greedyColoring(*options.graph, vertexOrder);
+            } else {
+                colors = greedyColoring(buildConflictGraph(csr), vertexOrder);
+            }
+            break;
+    }
+
     // 2) Подсчёт средней сложности по цветам
     int maxColor = 0;
     for (int c : colors) if (c > maxColor) maxColor = c;
     int colorCount = maxColor + 1;
+    LOG_INFO("Раскраска: цветов=" + std::to_string(colorCount) +
+             ", слотов=" + std::to_string(timeslots.size()));
 
     std::vector<int> sumDifficulty(colorCount, 0);
     std::vector<int> countPerColor(colorCount, 0);
 
     for (int i = 0; i < n; ++i) {
         int c = colors[i];
-        int diff = getExamDifficulty(exams[i], subjects);
+        int diff = getExamDifficulty(exams[i], index);
         sumDifficulty[c] += diff;
         countPerColor[c] += 1;
     }
@@ -157,12 +347,13 @@ std::vector<ExamAssignment> generateSchedule(
         double avg = (double)sumDifficulty[c] / (double)countPerColor[c];
         stats.push_back({c, avg});
 
-        logDebug("Цвет " + std::to_string(c) +
-                 ": экзаменов=" + std::to_string(countPerColor[c]) +
-                 ", средняя_сложность=" + std::to_string(avg));
+        LOG_DEBUG("Цвет " + std::to_string(c) +
+                  ": экзаменов=" + std::to_string(countPerColor[c]) +
+                  ", средняя_сложность=" + std::to_string(avg));
     }
 
     // 3) Сортируем цвета по средней сложности (от лёгких к сложным)
+    if (shuffled) std::shuffle(stats.begin(), stats.end(), rng);
     std::sort(stats.begin(), stats.end(),
         [](const ColorStat& a, const ColorStat& b) {
             return a.avg < b.avg;
@@ -192,10 +383,10 @@ std::vector<ExamAssignment> generateSchedule(
         colorToTimeslotIndex[color] = tsIndex;
 
         const Timeslot& ts = timeslots[tsIndex];
-        logInfo("Цвет " + std::to_string(color) +
-                " (avgDifficulty=" + std::to_string(stats[i].avg) + ")" +
-                " -> слот " + std::to_string(ts.id) +
-                " (" + ts.date + ")");
+        LOG_INFO("Цвет " + std::to_string(color) +
+                 " (avgDifficulty=" + std::to_string(stats[i].avg) + ")" +
+                 " -> слот " + std::to_string(ts.id) +
+                 " (" + ts.date + ")");
     }
 
     // если цветов больше, чем слотов – кидаем в последний
@@ -204,192 +395,135 @@ std::vector<ExamAssignment> generateSchedule(
         colorToTimeslotIndex[color] = timeslotOrder.back();
     }
 
-    // 6) Учёт занятости аудиторий в каждом слоте
-    std::map<int, std::vector<int>> usedRooms;
+    // 6) Учёт занятости: битовые множества экзаменов по слотам, занятость
+    //    аудиторий (best fit по вместимости), счётчики экзаменов группы по дням
+    SlotOccupancy occupancy(csr, index);
+    RoomPicker roomPicker(index, shuffled ? &rng : nullptr);
+    GroupDayCounters groupDay(exams, index, maxExamsPerDayForGroup);
+
+    for (int examIndex : vertexOrder) {
+        if (options.cancel && options.cancel->load(std::memory_order_relaxed)) {
+            LOG_WARN("Генерация прервана: назначено " + std::to_string(assignments.size()) +
+                     " из " + std::to_string(n));
+            if (options.interrupted) *options.interrupted = true;
+            break;
+        }
 
-    for (int examIndex = 0; examIndex < n; ++examIndex) {
         int color = colors[examIndex];
         if (color < 0 || color >= colorCount) {
-            logWarning("Некорректный цвет " + std::to_string(color) +
-                       " для examIndex=" + std::to_string(examIndex));
+            LOG_WARN("Некорректный цвет " + std::to_string(color) +
+                     " для examIndex=" + std::to_string(examIndex));
             color = 0;
         }
 
-        int tsIndex = colorToTimeslotIndex[color];
+        int tsIndex = index.timeslotIndex(timeslots[colorToTimeslotIndex[color]].id);
         const Timeslot& ts = timeslots[tsIndex];
         int timeslotId = ts.id;
 
         const Exam& exam = exams[examIndex];
         int groupId = exam.groupId;
 
-        const Group* group = findGroupByIdForScheduler(groups, groupId);
+        const Group* group = index.findGroup(groupId);
+        int requiredCapacity = group ? group->peopleCount : 0;
 
-        logDebug("Назначаем exam id=" + std::to_string(exam.id) +
-                 " (groupId=" + std::to_string(exam.groupId) +
-                 ", color=" + std::to_string(color) +
-                 ") в слот id=" + std::to_string(timeslotId));
+        LOG_DEBUG("Назначаем exam id=" + std::to_string(exam.id) +
+                  " (groupId=" + std::to_string(exam.groupId) +
+                  ", color=" + std::to_string(color) +
+                  ") в слот id=" + std::to_string(timeslotId));
 
         int chosenRoomId = -1;
 
         // --- 6.1 Проверка конфликтов в базовом слоте: по графу + по maxPerDay ---
         bool baseSlotHasConflict = false;
 
-        // a) конфликты по графу
-        for (const ExamAssignment& other : assignments) {
-            if (other.timeslotId != timeslotId) continue;
-            int otherExamIndex = other.examIndex;
-            if (otherExamIndex < 0 || otherExamIndex >= n) continue;
-            if (g.adj[examIndex][otherExamIndex]) {
-                baseSlotHasConflict = true;
-                break;
-            }
+        // a) конфликты по графу: строка смежности AND экзамены слота
+        if (occupancy.hasNeighborIn(examIndex, tsIndex)) {
+            baseSlotHasConflict = true;
         }
 
         // b) ограничение по maxExamsPerDayForGroup
         if (!baseSlotHasConflict &&
-            !canPlaceExamForGroupOnDate(
-                exam,
-                examIndex,
-                timeslotId,
-                assignments,
-                exams,
-                timeslots,
-                maxExamsPerDayForGroup
-            )
+            !groupDay.canPlace(examIndex, timeslotId)
         ) {
             baseSlotHasConflict = true;
-            logDebug("Базовый слот " + std::to_string(timeslotId) +
-                     " нарушает maxExamsPerDayForGroup для группы " +
-                     std::to_string(exam.groupId));
+            LOG_DEBUG("Базовый слот " + std::to_string(timeslotId) +
+                      " нарушает maxExamsPerDayForGroup для группы " +
+                      std::to_string(exam.groupId));
         }
 
         // --- 6.2 Если базовый слот ОК — пробуем найти аудиторию ---
         if (!baseSlotHasConflict) {
-            for (const Room& r : rooms) {
-                bool alreadyUsed = false;
-                auto it = usedRooms.find(timeslotId);
-                if (it != usedRooms.end()) {
-                    for (int usedId : it->second) {
-                        if (usedId == r.id) {
-                            alreadyUsed = true;
-                            break;
-                        }
-                    }
-                }
-
-                bool capacityOk = true;
-                if (group) {
-                    capacityOk = (r.capacity >= group->peopleCount);
-                }
-
-                if (!alreadyUsed && capacityOk) {
-                    chosenRoomId = r.id;
-                    usedRooms[timeslotId].push_back(r.id);
-
-                    logInfo("Экзамен id=" + std::to_string(exam.id) +
-                            " назначен в аудиторию " + r.name +
-                            " (capacity=" + std::to_string(r.capacity) + ")");
-                    break;
-                }
+            int pos = roomPicker.findBestFit(tsIndex, requiredCapacity);
+            if (pos != -1) {
+                const Room& r = roomPicker.room(pos);
+                chosenRoomId = r.id;
+                roomPicker.use(tsIndex, pos);
+
+                LOG_INFO("Экзамен id=" + std::to_string(exam.id) +
+                         " назначен в аудиторию " + r.name +
+                         " (capacity=" + std::to_string(r.capacity) + ")");
             }
 
             if (chosenRoomId == -1) {
-                logWarning("Не нашли аудиторию в базовом слоте " +
-                           std::to_string(timeslotId) +
-                           " для exam id=" + std::to_string(exam.id));
+                LOG_WARN("Не нашли аудиторию в базовом слоте " +
+                         std::to_string(timeslotId) +
+                         " для exam id=" + std::to_string(exam.id));
             }
         } else {
-            logWarning("В базовом слоте " + std::to_string(timeslotId) +
-                       " для exam id=" + std::to_string(exam.id) +
-                       " найден конфликт (граф или maxPerDay).");
+            LOG_WARN("В базовом слоте " + std::to_string(timeslotId) +
+                     " для exam id=" + std::to_string(exam.id) +
+                     " найден конфликт (граф или maxPerDay).");
         }
 
         // --- 6.3 Если базовый слот не подошёл или не нашли аудиторию —
         // пробуем альтернативные слоты
         if (chosenRoomId == -1) {
-            int newTimeslotId = timeslotId; // по умолчанию
+            int newTsIndex = tsIndex; // по умолчанию
             int newRoomId = -1;
 
             for (int altOrderIndex = 0;
                  altOrderIndex < (int)timeslotOrder.size();
                  ++altOrderIndex)
             {
-                int altTsIndex = timeslotOrder[altOrderIndex];
-                const Timeslot& altTs = timeslots[altTsIndex];
-                int altTimeslotId = altTs.id;
+                int altTsIndex = index.timeslotIndex(timeslots[timeslotOrder[altOrderIndex]].id);
+                int altTimeslotId = timeslots[altTsIndex].id;
 
                 if (altTimeslotId == timeslotId) continue;
 
                 // 1) графовые конфликты
-                bool hasGraphConflict = false;
-                for (const ExamAssignment& other : assignments) {
-                    if (other.timeslotId != altTimeslotId) continue;
-                    int otherExamIndex = other.examIndex;
-                    if (otherExamIndex < 0 || otherExamIndex >= n) continue;
-                    if (g.adj[examIndex][otherExamIndex]) {
-                        hasGraphConflict = true;
-                        break;
-                    }
-                }
-                if (hasGraphConflict) continue;
+                if (occupancy.hasNeighborIn(examIndex, altTsIndex)) continue;
 
                 // 2) ограничение по количеству экзаменов в день
-                if (!canPlaceExamForGroupOnDate(
-                        exam,
-                        examIndex,
-                        altTimeslotId,
-                        assignments,
-                        exams,
-                        timeslots,
-                        maxExamsPerDayForGroup
-                    )
-                ) {
+                if (!groupDay.canPlace(examIndex, altTimeslotId)) {
                     continue;
                 }
 
                 // 3) ищем аудиторию в этом слоте
-                for (const Room& r : rooms) {
-                    bool alreadyUsed = false;
-                    auto it2 = usedRooms.find(altTimeslotId);
-                    if (it2 != usedRooms.end()) {
-                        for (int usedId : it2->second) {
-                            if (usedId == r.id) {
-                                alreadyUsed = true;
-                                break;
-                            }
-                        }
-                    }
-
-                    bool capacityOk = true;
-                    if (group) {
-                        capacityOk = (r.capacity >= group->peopleCount);
-                    }
-
-                    if (!alreadyUsed && capacityOk) {
-                        newTimeslotId = altTimeslotId;
-                        newRoomId = r.id;
-                        usedRooms[altTimeslotId].push_back(r.id);
-
-                        logInfo("Переназначили exam id=" +
-                                std::to_string(exam.id) +
-                                " в альтернативный слот " +
-                                std::to_string(newTimeslotId) +
-                                " в аудиторию " + r.name +
-                                " (capacity=" + std::to_string(r.capacity) + ")");
-                        break;
-                    }
+                int pos = roomPicker.findBestFit(altTsIndex, requiredCapacity);
+                if (pos != -1) {
+                    const Room& r = roomPicker.room(pos);
+                    newTsIndex = altTsIndex;
+                    newRoomId = r.id;
+                    roomPicker.use(altTsIndex, pos);
+
+                    LOG_INFO("Переназначили exam id=" +
+                             std::to_string(exam.id) +
+                             " в альтернативный слот " +
+                             std::to_string(altTimeslotId) +
+                             " в аудиторию " + r.name +
+                             " (capacity=" + std::to_string(r.capacity) + ")");
+                    break;
                 }
-
-                if (newRoomId != -1) break;
             }
 
             if (newRoomId != -1) {
-                timeslotId   = newTimeslotId;
+                tsIndex      = newTsIndex;
+                timeslotId   = timeslots[newTsIndex].id;
                 chosenRoomId = newRoomId;
             } else {
-                logError("Даже после поиска альтернативных слотов НЕ НАЙДЕНА аудитория/слот для exam id=" +
-                         std::to_string(exam.id) +
-                         " (group=" + std::to_string(exam.groupId) + ").");
+                LOG_ERROR("Даже после поиска альтернативных слотов НЕ НАЙДЕНА аудитория/слот для exam id=" +
+                          std::to_string(exam.id) +
+                          " (group=" + std::to_string(exam.groupId) + ").");
             }
         }
 
@@ -399,8 +533,19 @@ std::vector<ExamAssignment> generateSchedule(
         a.roomId     = chosenRoomId;
 
         assignments.push_back(a);
+        occupancy.placeExam(tsIndex, examIndex);
+        groupDay.add(examIndex, timeslotId);
+    }
+
+    if (shuffled) {
+        // порядок назначений в ответе — как у экзаменов во входных данных
+        std::sort(assignments.begin(), assignments.end(),
+            [](const ExamAssignment& a, const ExamAssignment& b) {
+                return a.examIndex < b.examIndex;
+            }
+        );
     }
 
-    logInfo("=== Генерация расписания завершена ===");
+    LOG_INFO("=== Генерация расписания завершена ===");
     return assignments;
 }
\ No newline at end of file
@@ -1,13 +1,67 @@
 #pragma once
 
+#include <atomic>
+#include <string>
 #include <vector>
 #include "model.h"
 
+class InstanceIndex;
+struct ExactSolverResult;
+struct ConflictGraph;
+struct CsrConflictGraph;
+
+// Алгоритм раскраски графа конфликтов
+enum class ColoringAlgorithm {
+    Greedy, // "graph"  — жадная раскраска в порядке входных данных
+    Dsatur, // "dsatur" — DSATUR, обычно даёт меньше цветов
+    Parallel, // "parallel" — Джонс–Плассман на нескольких потоках, для больших сессий
+    Exact   // "exact"  — точный поиск (exact_solver.h), при неудаче — DSATUR
+};
+
+struct GeneratorOptions {
+    ColoringAlgorithm coloring = ColoringAlgorithm::Greedy;
+    unsigned seed = 1;    // seed случайных приоритетов для "parallel"
+    int threads = 0;      // число потоков для "parallel", 0 — по числу ядер
+    unsigned shuffleSeed = 0; // != 0 — случайный вариант: порядок вершин, равенства, порядок аудиторий
+    int exactTimeLimitMs = 5000; // лимит точного поиска для "exact"
+    const std::atomic<bool>* cancel = nullptr; // кооперативная отмена: true — прервать генерацию
+    bool* interrupted = nullptr; // если задан: true, когда генерация прервана по cancel и результат неполон
+    // Граф конфликтов тех же exams, построенный заранее и общий для нескольких
+    // запусков, например вариантов мультистарта. nullptr — строится в generateSchedule.
+    // csr нужен всем алгоритмам; плотный graph (buildConflictGraph по csr) — только Greedy
+    const CsrConflictGraph* csr = nullptr;
+    const ConflictGraph* graph = nullptr;
+};
+
+// "graph" / "dsatur" / "parallel" / "exact" -> алгоритм; false, если имя не распознано
+bool parseColoringAlgorithm(const std::string& name, ColoringAlgorithm& out);
+std::string coloringAlgorithmName(ColoringAlgorithm algorithm);
+
 std::vector<ExamAssignment> generateSchedule(
     const std::vector<Exam>& exams,
     const std::vector<Group>& groups,
     const std::vector<Subject>& subjects,
     const std::vector<Timeslot>& timeslots,
     const std::vector<Room>& rooms,
-    int maxExamsPerDayForGroup
+    int maxExamsPerDayForGroup,
+    const GeneratorOptions& options = GeneratorOptions()
+);
+
+// То же, но по заранее построенному индексу сущностей запроса
+std::vector<ExamAssignment> generateSchedule(
+    const std::vector<Exam>& exams,
+    const InstanceIndex& index,
+    int maxExamsPerDayForGroup,
+    const GeneratorOptions& options = GeneratorOptions()
+);
+
+// Алгоритм "exact": точный поиск (exact_solver.h), если он не дал расписания —
+// generateSchedule через DSATUR. В exact — итог точного поиска (статус, причина
+// Infeasible); assignments в нём не остаются
+std::vector<ExamAssignment> generateScheduleExact(
+    const std::vector<Exam>& exams,
+    const InstanceIndex& index,
+    int maxExamsPerDayForGroup,
+    const GeneratorOptions& options,
+    ExactSolverResult& exact
 );
@@ -1,5 +1,14 @@
 #include "graph.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <set>
+#include <thread>
+#include <unordered_map>
+
 bool areConflicting(const Exam& a, const Exam& b) {
     if (a.groupId == b.groupId) return true;
 
@@ -8,43 +17,341 @@ bool areConflicting(const Exam& a, const Exam& b) {
     return false;
 }
 
-ConflictGraph buildConflictGraph(const std::vector<Exam>& exams) {
+// Раскладывает индексы экзаменов по корзинам с одинаковым ключом (groupId / teacherId).
+// Результат — плоский массив items, корзина b занимает items[starts[b] .. starts[b + 1]).
+template <typename KeyFn>
+static void bucketExams(
+    const std::vector<Exam>& exams,
+    KeyFn key,
+    std::vector<int>& starts,
+    std::vector<int>& items
+) {
     int n = exams.size();
-    ConflictGraph g(n);
+    std::unordered_map<int, int> bucketOf;
+    bucketOf.reserve(n);
 
+    std::vector<int> examBucket(n);
     for (int i = 0; i < n; ++i) {
-        for (int j = i + 1; j < n; ++j) {
-            if (areConflicting(exams[i], exams[j])) {
-                g.adj[i][j] = true;
-                g.adj[j][i] = true;
+        auto it = bucketOf.emplace(key(exams[i]), (int)bucketOf.size()).first;
+        examBucket[i] = it->second;
+    }
+
+    // сортировка подсчётом по номеру корзины
+    int bucketCount = bucketOf.size();
+    starts.assign(bucketCount + 1, 0);
+    for (int i = 0; i < n; ++i) starts[examBucket[i] + 1]++;
+    for (int b = 0; b < bucketCount; ++b) starts[b + 1] += starts[b];
+
+    items.assign(n, 0);
+    std::vector<int> fill(starts.begin(), starts.end() - 1);
+    for (int i = 0; i < n; ++i) items[fill[examBucket[i]]++] = i;
+}
+
+CsrConflictGraph buildCsrConflictGraph(const std::vector<Exam>& exams) {
+    int n = exams.size();
+    CsrConflictGraph g;
+    g.n = n;
+
+    std::vector<int> groupStarts, groupItems;
+    std::vector<int> teacherStarts, teacherItems;
+    bucketExams(exams, [](const Exam& e) { return e.groupId; }, groupStarts, groupItems);
+    bucketExams(exams, [](const Exam& e) { return e.teacherId; }, teacherStarts, teacherItems);
+
+    // 1) верхняя оценка степени: пара с общей группой И общим преподавателем посчитается дважды
+    std::vector<int> rawOffsets(n + 1, 0);
+    auto countBuckets = [&](const std::vector<int>& starts, const std::vector<int>& items) {
+        for (int b = 0; b + 1 < (int)starts.size(); ++b) {
+            int size = starts[b + 1] - starts[b];
+            for (int k = starts[b]; k < starts[b + 1]; ++k) {
+                rawOffsets[items[k] + 1] += size - 1;
             }
         }
+    };
+    countBuckets(groupStarts, groupItems);
+    countBuckets(teacherStarts, teacherItems);
+    for (int v = 0; v < n; ++v) rawOffsets[v + 1] += rawOffsets[v];
+
+    // 2) раскладываем рёбра внутри каждой корзины
+    std::vector<int> raw(rawOffsets[n]);
+    std::vector<int> fill(rawOffsets.begin(), rawOffsets.end() - 1);
+    auto emitBuckets = [&](const std::vector<int>& starts, const std::vector<int>& items) {
+        for (int b = 0; b + 1 < (int)starts.size(); ++b) {
+            for (int k = starts[b]; k < starts[b + 1]; ++k) {
+                int u = items[k];
+                for (int l = starts[b]; l < starts[b + 1]; ++l) {
+                    if (l != k) raw[fill[u]++] = items[l];
+                }
+            }
+        }
+    };
+    emitBuckets(groupStarts, groupItems);
+    emitBuckets(teacherStarts, teacherItems);
+
+    // 3) сортируем строки, убираем дубли и уплотняем
+    g.offsets.assign(n + 1, 0);
+    g.neighbors.reserve(raw.size());
+    for (int v = 0; v < n; ++v) {
+        auto first = raw.begin() + rawOffsets[v];
+        auto last  = raw.begin() + rawOffsets[v + 1];
+        std::sort(first, last);
+        last = std::unique(first, last);
+        g.neighbors.insert(g.neighbors.end(), first, last);
+        g.offsets[v + 1] = g.neighbors.size();
     }
 
     return g;
 }
 
+ConflictGraph buildConflictGraph(const CsrConflictGraph& csr) {
+    ConflictGraph g(csr.n);
+
+    for (int v = 0; v < csr.n; ++v) {
+        uint64_t* r = g.row(v);
+        for (const int* it = csr.begin(v); it != csr.end(v); ++it) {
+            setBit(r, *it);
+        }
+    }
+
+    return g;
+}
+
+ConflictGraph buildConflictGraph(const std::vector<Exam>& exams) {
+    return buildConflictGraph(buildCsrConflictGraph(exams));
+}
+
+// Тождественная перестановка 0..n-1
+static std::vector<int> identityOrder(int n) {
+    std::vector<int> order(n);
+    for (int v = 0; v < n; ++v) order[v] = v;
+    return order;
+}
+
 std::vector<int> greedyColoring(const ConflictGraph& g) {
+    return greedyColoring(g, identityOrder(g.n));
+}
+
+std::vector<int> greedyColoring(const ConflictGraph& g, const std::vector<int>& order) {
     int n = g.n;
     std::vector<int> color(n, -1);
 
+    // уже окрашенные вершины — битовое множество той же ширины, что строка матрицы
+    BitWords colored(g.words, 0);
+    // занятые у соседей цвета; цветов не больше n
+    std::vector<uint64_t> used(wordsForBits(n + 1), 0);
+    int maxColor = -1;
+
+    for (int v : order) {
+        // отметить занятые цвета у уже окрашенных соседей: row(v) & colored
+        int usedWords = wordsForBits(maxColor + 2);
+        std::fill(used.begin(), used.begin() + usedWords, 0);
+        g.forEachNeighborIn(v, colored.data(), [&](int u) {
+            setBit(used.data(), color[u]);
+        });
+
+        // найти минимальный свободный цвет: первое слово с нулевым битом
+        int c = 0;
+        for (int w = 0; w < usedWords; ++w) {
+            if (~used[w]) {
+                c = w * kWordBits + ctz64(~used[w]);
+                break;
+            }
+        }
+
+        color[v] = c;
+        if (c > maxColor) maxColor = c;
+        setBit(colored.data(), v);
+    }
+
+    return color;
+}
+
+std::vector<int> dsaturColoring(const CsrConflictGraph& g) {
+    return dsaturColoring(g, identityOrder(g.n));
+}
+
+std::vector<int> dsaturColoring(const CsrConflictGraph& g, const std::vector<int>& tieRank) {
+    int n = g.n;
+    std::vector<int> color(n, -1);
+    if (n == 0) return color;
+
+    std::vector<int> vertexByRank(n);
+    for (int v = 0; v < n; ++v) vertexByRank[tieRank[v]] = v;
+
+    // битовая карта цветов соседей (растёт по мере надобности: цветов не больше
+    // степени + 1), насыщенность и степень в неокрашенном подграфе
+    std::vector<std::vector<uint64_t>> neighborColors(n);
+    std::vector<int> saturation(n, 0);
+    std::vector<int> uncoloredDegree(n);
+
+    // корзины по насыщенности; внутри корзины порядок по (-степень, tieRank)
+    std::vector<std::set<std::pair<int, int>>> buckets(n);
     for (int v = 0; v < n; ++v) {
-        // отметить занятые цвета у соседей
-        std::vector<bool> used(n, false); // максимум n цветов
-        for (int u = 0; u < n; ++u) {
-            if (g.adj[v][u] && color[u] != -1) {
-                used[color[u]] = true;
+        uncoloredDegree[v] = g.degree(v);
+        buckets[0].insert({-uncoloredDegree[v], tieRank[v]});
+    }
+    int maxSat = 0;
+
+    for (int step = 0; step < n; ++step) {
+        while (buckets[maxSat].empty()) --maxSat;
+
+        auto top = buckets[maxSat].begin();
+        int v = vertexByRank[top->second];
+        buckets[maxSat].erase(top);
+
+        // минимальный цвет, которого нет у соседей: первое слово с нулевым битом
+        const std::vector<uint64_t>& used = neighborColors[v];
+        int c = (int)used.size() * kWordBits;
+        for (int w = 0; w < (int)used.size(); ++w) {
+            if (~used[w]) {
+                c = w * kWordBits + ctz64(~used[w]);
+                break;
             }
         }
+        color[v] = c;
+        std::vector<uint64_t>().swap(neighborColors[v]);
 
-        // найти минимальный свободный цвет
-        int c = 0;
-        while (c < n && used[c]) {
-            ++c;
+        // обновляем насыщенность и степень неокрашенных соседей
+        for (const int* it = g.begin(v); it != g.end(v); ++it) {
+            int u = *it;
+            if (color[u] != -1) continue;
+
+            std::vector<uint64_t>& nc = neighborColors[u];
+            buckets[saturation[u]].erase({-uncoloredDegree[u], tieRank[u]});
+
+            // новый цвет у соседа — O(1)
+            size_t word = (size_t)c / kWordBits;
+            if (nc.size() <= word) nc.resize(word + 1, 0);
+            if (!testBit(nc.data(), c)) {
+                setBit(nc.data(), c);
+                saturation[u]++;
+            }
+            uncoloredDegree[u]--;
+
+            int newSat = saturation[u];
+            buckets[newSat].insert({-uncoloredDegree[u], tieRank[u]});
+            if (newSat > maxSat) maxSat = newSat;
         }
+    }
 
-        color[v] = c;
+    return color;
+}
+
+namespace {
+
+// Барьер для фиксированного числа потоков (в C++17 нет std::barrier)
+class RoundBarrier {
+public:
+    explicit RoundBarrier(int count) : count_(count), waiting_(0), generation_(0) {}
+
+    void arriveAndWait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        long gen = generation_;
+        if (++waiting_ == count_) {
+            waiting_ = 0;
+            ++generation_;
+            cv_.notify_all();
+            return;
+        }
+        cv_.wait(lock, [&] { return gen != generation_; });
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    int count_;
+    int waiting_;
+    long generation_;
+};
+
+} // namespace
+
+std::vector<int> jonesPlassmannColoring(
+    const CsrConflictGraph& g,
+    unsigned seed,
+    int threadCount
+) {
+    int n = g.n;
+    std::vector<int> color(n, -1);
+    if (n == 0) return color;
+
+    // приоритеты генерируются последовательно — раскраска воспроизводима по seed
+    std::vector<uint64_t> priority(n);
+    std::mt19937 rng(seed);
+    for (int v = 0; v < n; ++v) {
+        // старшие биты — случайное число, младшие — номер вершины (строгий порядок)
+        priority[v] = ((uint64_t)rng() << 32) | (uint32_t)v;
+    }
+
+    if (threadCount <= 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
     }
+    // на маленьких графах синхронизация дороже самой раскраски
+    const int minVerticesPerThread = 1024;
+    threadCount = std::max(1, std::min(threadCount, (n + minVerticesPerThread - 1) / minVerticesPerThread));
+
+    RoundBarrier barrier(threadCount);
+    std::vector<int> coloredInRound(threadCount, 0);
+    int remaining = n;
+
+    auto worker = [&](int t) {
+        int lo = (int)((long long)n * t / threadCount);
+        int hi = (int)((long long)n * (t + 1) / threadCount);
+
+        std::vector<int> pending;
+        for (int v = lo; v < hi; ++v) pending.push_back(v);
+
+        std::vector<int> selected;
+        std::vector<char> used;
+
+        while (true) {
+            // фаза 1: выбираем вершины, чей приоритет выше, чем у всех неокрашенных соседей
+            selected.clear();
+            for (int v : pending) {
+                bool isMax = true;
+                for (const int* it = g.begin(v); it != g.end(v); ++it) {
+                    int u = *it;
+                    if (color[u] == -1 && priority[u] > priority[v]) {
+                        isMax = false;
+                        break;
+                    }
+                }
+                if (isMax) selected.push_back(v);
+            }
+            barrier.arriveAndWait();
+
+            // фаза 2: красим независимое множество; соседи выбранных вершин в этом раунде не меняются
+            for (int v : selected) {
+                int deg = g.degree(v);
+                used.assign(deg + 1, 0);
+                for (const int* it = g.begin(v); it != g.end(v); ++it) {
+                    int c = color[*it];
+                    if (c != -1 && c <= deg) used[c] = 1;
+                }
+                int c = 0;
+                while (used[c]) ++c;
+                color[v] = c;
+            }
+            pending.erase(
+                std::remove_if(pending.begin(), pending.end(),
+                               [&](int v) { return color[v] != -1; }),
+                pending.end()
+            );
+            coloredInRound[t] = (int)selected.size();
+            barrier.arriveAndWait();
+
+            // фаза 3: поток 0 подводит итог раунда
+            if (t == 0) {
+                for (int k = 0; k < threadCount; ++k) remaining -= coloredInRound[k];
+            }
+            barrier.arriveAndWait();
+            if (remaining == 0) break;
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threadCount; ++t) pool.emplace_back(worker, t);
+    worker(0);
+    for (std::thread& th : pool) th.join();
 
     return color;
-}
\ No newline at end of file
+}
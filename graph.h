@@ -1,14 +1,107 @@
 #include "model.h"
+#include "bitops.h"
 
 #pragma once
 
+// Граф конфликтов в виде битовой матрицы смежности:
+// одна непрерывная выровненная аллокация, строка вершины v — words слов по 64 бита.
 struct ConflictGraph {
-    int n; // Количестиво вершин
-    std::vector<std::vector<bool>> adj; // adj[i][j] = true, если есть ребро
+    int n;        // Количество вершин
+    int words;    // Количество 64-битных слов в строке (кратно кэш-линии)
+    BitWords adj; // adj[v * words + u / 64], бит u % 64 = 1, если есть ребро
 
-    ConflictGraph(int n) : n(n), adj(n, std::vector<bool>(n, false)) {}
+    ConflictGraph(int n)
+        : n(n),
+          words(rowWords(n)),
+          adj((size_t)n * (size_t)rowWords(n), 0) {}
+
+    const uint64_t* row(int v) const { return adj.data() + (size_t)v * words; }
+    uint64_t* row(int v) { return adj.data() + (size_t)v * words; }
+
+    bool hasEdge(int u, int v) const { return testBit(row(u), v); }
+
+    void addEdge(int u, int v) {
+        setBit(row(u), v);
+        setBit(row(v), u);
+    }
+
+    // Степень вершины через popcount по строке
+    int degree(int v) const {
+        const uint64_t* r = row(v);
+        int deg = 0;
+        for (int w = 0; w < words; ++w) deg += popcount64(r[w]);
+        return deg;
+    }
+
+    // Есть ли у v сосед среди вершин множества bits (слово за словом)
+    bool intersects(int v, const uint64_t* bits) const {
+        const uint64_t* r = row(v);
+        for (int w = 0; w < words; ++w) {
+            if (r[w] & bits[w]) return true;
+        }
+        return false;
+    }
+
+    // Вызывает f(u) для каждого соседа u вершины v, входящего в bits
+    template <typename F>
+    void forEachNeighborIn(int v, const uint64_t* bits, F&& f) const {
+        const uint64_t* r = row(v);
+        for (int w = 0; w < words; ++w) {
+            uint64_t m = r[w] & bits[w];
+            while (m) {
+                f(w * kWordBits + ctz64(m));
+                m &= m - 1;
+            }
+        }
+    }
+
+    // Слов в строке: округляем до целой кэш-линии, чтобы каждая строка была выровнена
+    static int rowWords(int n) {
+        const int wordsPerLine = (int)(kCacheLineBytes / sizeof(uint64_t));
+        int w = wordsForBits(n);
+        return (w + wordsPerLine - 1) / wordsPerLine * wordsPerLine;
+    }
+};
+
+// Разреженный граф конфликтов в формате CSR (compressed sparse row):
+// соседи вершины v — neighbors[offsets[v] .. offsets[v + 1]), отсортированы по возрастанию.
+struct CsrConflictGraph {
+    int n = 0;                  // Количество вершин
+    std::vector<int> offsets;   // n + 1 элементов
+    std::vector<int> neighbors; // 2 * m элементов (каждое ребро в обе стороны)
+
+    int degree(int v) const { return offsets[v + 1] - offsets[v]; }
+    const int* begin(int v) const { return neighbors.data() + offsets[v]; }
+    const int* end(int v) const { return neighbors.data() + offsets[v + 1]; }
+    long long edgeCount() const { return (long long)neighbors.size() / 2; }
 };
 
 bool areConflicting(const Exam& a, const Exam& b);
+
+// Рёбра строятся только внутри корзин "одна группа" и "один преподаватель",
+// без попарного перебора всех экзаменов
+CsrConflictGraph buildCsrConflictGraph(const std::vector<Exam>& exams);
+ConflictGraph buildConflictGraph(const CsrConflictGraph& csr);
 ConflictGraph buildConflictGraph(const std::vector<Exam>& exams);
-std::vector<int> greedyColoring(const ConflictGraph& g);
\ No newline at end of file
+std::vector<int> greedyColoring(const ConflictGraph& g);
+// Жадная раскраска в заданном порядке обхода вершин (order — перестановка 0..n-1)
+std::vector<int> greedyColoring(const ConflictGraph& g, const std::vector<int>& order);
+
+// DSATUR: следующей красится вершина с максимальной насыщенностью
+// (числом различных цветов у соседей), при равенстве — с большей степенью
+// в ещё не окрашенном подграфе. Цвета соседей — битовая карта на вершину,
+// обновление насыщенности O(1); корзины — std::set, итого O((n + m) log n).
+std::vector<int> dsaturColoring(const CsrConflictGraph& g);
+// То же, но при равных насыщенности и степени раньше идёт вершина с меньшим
+// tieRank[v] (tieRank — перестановка 0..n-1); без него — меньший номер вершины.
+std::vector<int> dsaturColoring(const CsrConflictGraph& g, const std::vector<int>& tieRank);
+
+// Параллельная раскраска Джонса–Плассмана: вершины получают случайные приоритеты
+// от seed, в каждом раунде локальные максимумы среди неокрашенных соседей образуют
+// независимое множество и красятся одновременно. Результат зависит только от seed,
+// но не от числа потоков. threadCount <= 0 — по числу ядер.
+std::vector<int> jonesPlassmannColoring(
+    const CsrConflictGraph& g,
+    unsigned seed,
+    int threadCount = 0
+);
@@ -0,0 +1,117 @@
+// instance_index.cpp
+#include "instance_index.h"
+
+#include <algorithm>
+#include <string>
+
+void IdIndex::buildFromIds(const std::vector<int>& ids) {
+    table_.clear();
+    keys_.clear();
+    values_.clear();
+    flat_ = true;
+    minId_ = 0;
+
+    if (ids.empty()) return;
+
+    auto mm = std::minmax_element(ids.begin(), ids.end());
+    long long range = (long long)*mm.second - (long long)*mm.first + 1;
+
+    // Плоский массив, если он не сильно больше самого набора id
+    if (range <= 4 * (long long)ids.size() + 64) {
+        flat_ = true;
+        minId_ = *mm.first;
+        table_.assign((size_t)range, -1);
+        for (int i = 0; i < (int)ids.size(); ++i) {
+            int& slot = table_[(size_t)(ids[i] - minId_)];
+            if (slot == -1) slot = i;
+        }
+        return;
+    }
+
+    // Иначе — открытая адресация с линейным пробированием, заполнение не выше 50%
+    flat_ = false;
+    size_t capacity = 16;
+    while (capacity < ids.size() * 2) capacity <<= 1;
+    keys_.assign(capacity, 0);
+    values_.assign(capacity, -1);
+
+    size_t mask = capacity - 1;
+    for (int i = 0; i < (int)ids.size(); ++i) {
+        for (size_t pos = hashId(ids[i]) & mask; ; pos = (pos + 1) & mask) {
+            if (values_[pos] == -1) {
+                keys_[pos] = ids[i];
+                values_[pos] = i;
+                break;
+            }
+            if (keys_[pos] == ids[i]) break; // дубликат id — оставляем первый
+        }
+    }
+}
+
+InstanceIndex::InstanceIndex(
+    const std::vector<Group>& groups,
+    const std::vector<Teacher>& teachers,
+    const std::vector<Subject>& subjects,
+    const std::vector<Room>& rooms,
+    const std::vector<Timeslot>& timeslots
+)
+    : groups_(&groups),
+      teachers_(&teachers),
+      subjects_(&subjects),
+      rooms_(&rooms),
+      timeslots_(&timeslots) {
+    groupIdx_.build(groups);
+    teacherIdx_.build(teachers);
+    subjectIdx_.build(subjects);
+    roomIdx_.build(rooms);
+    timeslotIdx_.build(timeslots);
+
+    // дни сессии: различные даты слотов в порядке возрастания
+    std::vector<std::string> dates;
+    dates.reserve(timeslots.size());
+    for (const Timeslot& t : timeslots) dates.push_back(t.date);
+    std::sort(dates.begin(), dates.end());
+    dates.erase(std::unique(dates.begin(), dates.end()), dates.end());
+
+    dayCount_ = dates.size();
+    timeslotDay_.resize(timeslots.size());
+    for (int i = 0; i < (int)timeslots.size(); ++i) {
+        timeslotDay_[i] = std::lower_bound(dates.begin(), dates.end(), timeslots[i].date) - dates.begin();
+    }
+    dayDates_ = std::move(dates);
+
+    // пересечения слотов: по дням, заметающей прямой по началу слота. Активные —
+    // слоты дня, которые ещё не закончились; каждый новый сравнивается только с ними,
+    // так что работа — O(T log T + число пересекающихся пар)
+    overlaps_.assign(timeslots.size(), {});
+    std::vector<int> order;
+    order.reserve(timeslots.size());
+    for (int i = 0; i < (int)timeslots.size(); ++i) {
+        if (timeslotIdx_.find(timeslots[i].id) == i) order.push_back(i);
+    }
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        if (timeslotDay_[a] != timeslotDay_[b]) return timeslotDay_[a] < timeslotDay_[b];
+        return timeslots[a].startMinutes < timeslots[b].startMinutes;
+    });
+
+    std::vector<int> active;
+    for (int k = 0; k < (int)order.size(); ++k) {
+        int s = order[k];
+        const Timeslot& t = timeslots[s];
+        if (k == 0 || timeslotDay_[order[k - 1]] != timeslotDay_[s]) active.clear();
+
+        int kept = 0;
+        for (int a : active) {
+            if (timeslots[a].endMinutes <= t.startMinutes) continue; // закончился
+            active[kept++] = a;
+            if (timeslotsOverlap(timeslots[a], t)) {
+                overlaps_[a].push_back(s);
+                overlaps_[s].push_back(a);
+                hasOverlaps_ = true;
+            }
+        }
+        active.resize(kept);
+        active.push_back(s);
+    }
+    for (std::vector<int>& list : overlaps_) std::sort(list.begin(), list.end());
+}
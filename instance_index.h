@@ -0,0 +1,128 @@
+// instance_index.h — предвычисленные таблицы id -> индекс для всех сущностей запроса
+#pragma once
+
+#include <string>
+#include <vector>
+#include "model.h"
+
+// Отображение id сущности в плотный индекс (позицию в её векторе).
+// Если id компактны — плоский массив по (id - minId), иначе хеш-таблица
+// с открытой адресацией. При повторяющихся id побеждает первое вхождение,
+// как при линейном поиске.
+class IdIndex {
+public:
+    template <typename T>
+    void build(const std::vector<T>& items) {
+        std::vector<int> ids;
+        ids.reserve(items.size());
+        for (const T& item : items) ids.push_back(item.id);
+        buildFromIds(ids);
+    }
+
+    void buildFromIds(const std::vector<int>& ids);
+
+    // Индекс по id или -1, если такого id нет
+    int find(int id) const {
+        if (flat_) {
+            long long k = (long long)id - minId_;
+            if (k < 0 || k >= (long long)table_.size()) return -1;
+            return table_[k];
+        }
+        if (keys_.empty()) return -1;
+        size_t mask = keys_.size() - 1;
+        for (size_t pos = hashId(id) & mask; ; pos = (pos + 1) & mask) {
+            if (values_[pos] == -1) return -1;
+            if (keys_[pos] == id) return values_[pos];
+        }
+    }
+
+    bool isFlat() const { return flat_; }
+
+private:
+    static size_t hashId(int id) {
+        // мультипликативное хеширование (Фибоначчи)
+        return (size_t)(((unsigned long long)(unsigned)id * 11400714819323198485ULL) >> 32);
+    }
+
+    bool flat_ = true;
+    long long minId_ = 0;
+    std::vector<int> table_;   // плоский режим: table_[id - minId] = индекс или -1
+
+    std::vector<int> keys_;    // хеш-режим: ключи
+    std::vector<int> values_;  // хеш-режим: индексы, -1 — пустая ячейка
+};
+
+// Слоты пересекаются по времени: один день и общий отрезок [start, end)
+inline bool timeslotsOverlap(const Timeslot& a, const Timeslot& b) {
+    return a.date == b.date && a.startMinutes < b.endMinutes && b.startMinutes < a.endMinutes;
+}
+
+// Индекс одного экземпляра задачи (группы, преподаватели, предметы, аудитории, слоты).
+// Строится один раз на запрос и используется генератором, валидатором и сборкой ExamView.
+// Хранит ссылки на исходные векторы — они должны жить дольше индекса.
+class InstanceIndex {
+public:
+    InstanceIndex(
+        const std::vector<Group>& groups,
+        const std::vector<Teacher>& teachers,
+        const std::vector<Subject>& subjects,
+        const std::vector<Room>& rooms,
+        const std::vector<Timeslot>& timeslots
+    );
+
+    const std::vector<Group>&    groups()    const { return *groups_; }
+    const std::vector<Teacher>&  teachers()  const { return *teachers_; }
+    const std::vector<Subject>&  subjects()  const { return *subjects_; }
+    const std::vector<Room>&     rooms()     const { return *rooms_; }
+    const std::vector<Timeslot>& timeslots() const { return *timeslots_; }
+
+    int groupIndex(int id)    const { return groupIdx_.find(id); }
+    int teacherIndex(int id)  const { return teacherIdx_.find(id); }
+    int subjectIndex(int id)  const { return subjectIdx_.find(id); }
+    int roomIndex(int id)     const { return roomIdx_.find(id); }
+    int timeslotIndex(int id) const { return timeslotIdx_.find(id); }
+
+    const Group*    findGroup(int id)    const { return at(*groups_, groupIdx_.find(id)); }
+    const Teacher*  findTeacher(int id)  const { return at(*teachers_, teacherIdx_.find(id)); }
+    const Subject*  findSubject(int id)  const { return at(*subjects_, subjectIdx_.find(id)); }
+    const Room*     findRoom(int id)     const { return at(*rooms_, roomIdx_.find(id)); }
+    const Timeslot* findTimeslot(int id) const { return at(*timeslots_, timeslotIdx_.find(id)); }
+
+    // Плотный номер дня (по возрастанию даты) для слота с индексом timeslotIndex
+    int dayOfTimeslot(int timeslotIndex) const { return timeslotDay_[timeslotIndex]; }
+    int dayCount() const { return dayCount_; }
+    // Дата дня с плотным номером day
+    const std::string& dayDate(int day) const { return dayDates_[day]; }
+
+    // Слоты (индексы), которые пересекаются по времени со слотом timeslotIndex,
+    // кроме него самого, по возрастанию. Для повторов id пусто — их заменяет первое вхождение
+    const std::vector<int>& overlappingTimeslots(int timeslotIndex) const { return overlaps_[timeslotIndex]; }
+    // false — все различные слоты попарно не пересекаются (обычный случай),
+    // и конфликт — это только совпадение слота
+    bool hasTimeslotOverlaps() const { return hasOverlaps_; }
+
+private:
+    template <typename T>
+    static const T* at(const std::vector<T>& items, int index) {
+        return index < 0 ? nullptr : &items[index];
+    }
+
+    const std::vector<Group>*    groups_;
+    const std::vector<Teacher>*  teachers_;
+    const std::vector<Subject>*  subjects_;
+    const std::vector<Room>*     rooms_;
+    const std::vector<Timeslot>* timeslots_;
+
+    IdIndex groupIdx_;
+    IdIndex teacherIdx_;
+    IdIndex subjectIdx_;
+    IdIndex roomIdx_;
+    IdIndex timeslotIdx_;
+
+    std::vector<int> timeslotDay_;
+    std::vector<std::string> dayDates_;
+    int dayCount_ = 0;
+
+    std::vector<std::vector<int>> overlaps_;
+    bool hasOverlaps_ = false;
+};
@@ -0,0 +1,198 @@
+// job_queue.cpp
+#include "job_queue.h"
+
+#include "logger.h"
+
+#include <cstdio>
+#include <exception>
+#include <random>
+
+const char* jobStateName(JobState state) {
+    switch (state) {
+        case JobState::Queued: return "queued";
+        case JobState::Running: return "running";
+        case JobState::Done: return "done";
+        case JobState::Failed: return "failed";
+        case JobState::Cancelled: return "cancelled";
+    }
+    return "failed";
+}
+
+struct JobRecord {
+    std::string id;
+    long ownerId = 0;
+    JobQueue::Task task;
+
+    std::atomic<bool> cancel{false};
+
+    // поля ниже — под mutex
+    mutable std::mutex mutex;
+    JobState state = JobState::Queued;
+    double progress = 0.0;
+    std::string stage = "queued";
+    std::string resultJson;
+    std::string error;
+};
+
+const std::atomic<bool>* JobContext::cancelFlag() const {
+    return &job_->cancel;
+}
+
+bool JobContext::cancelled() const {
+    return job_->cancel.load(std::memory_order_relaxed);
+}
+
+void JobContext::setProgress(const std::string& stage, double progress) {
+    std::lock_guard<std::mutex> lock(job_->mutex);
+    job_->stage = stage;
+    job_->progress = progress < 0.0 ? 0.0 : (progress > 1.0 ? 1.0 : progress);
+}
+
+JobQueue::JobQueue(int workerCount, std::size_t capacity, std::size_t keepFinished)
+    : capacity_(capacity), keepFinished_(keepFinished) {
+    std::random_device rd;
+    idSalt_ = ((unsigned long long)rd() << 32) ^ rd();
+
+    if (workerCount < 1) workerCount = 1;
+    for (int i = 0; i < workerCount; ++i) {
+        workers_.emplace_back([this] { workerLoop(); });
+    }
+    logInfo("Очередь задач: потоков=" + std::to_string(workerCount) +
+            ", мест=" + std::to_string(capacity));
+}
+
+JobQueue::~JobQueue() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        for (auto& entry : jobs_) entry.second->cancel.store(true);
+    }
+    cv_.notify_all();
+    for (std::thread& t : workers_) t.join();
+}
+
+std::optional<std::string> JobQueue::submit(long ownerId, Task task) {
+    auto job = std::make_shared<JobRecord>();
+    job->ownerId = ownerId;
+    job->task = std::move(task);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_ || queue_.size() >= capacity_) return std::nullopt;
+
+        // номер задачи, перемешанный с солью, — чтобы id нельзя было перебрать подряд
+        std::mt19937_64 mix(idSalt_ + (++nextSeq_));
+        char buf[33];
+        std::snprintf(buf, sizeof(buf), "%016llx%016llx",
+                      (unsigned long long)mix(), (unsigned long long)nextSeq_);
+        job->id = buf;
+
+        jobs_[job->id] = job;
+        queue_.push_back(job);
+    }
+    cv_.notify_one();
+    return job->id;
+}
+
+std::optional<JobInfo> JobQueue::find(const std::string& id) const {
+    std::shared_ptr<JobRecord> job;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = jobs_.find(id);
+        if (it == jobs_.end()) return std::nullopt;
+        job = it->second;
+    }
+
+    std::lock_guard<std::mutex> lock(job->mutex);
+    return JobInfo{job->id, job->ownerId, job->state, job->progress, job->stage, job->resultJson, job->error};
+}
+
+bool JobQueue::cancel(const std::string& id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = jobs_.find(id);
+    if (it == jobs_.end()) return false;
+    std::shared_ptr<JobRecord> job = it->second;
+
+    std::lock_guard<std::mutex> jobLock(job->mutex);
+    if (job->state == JobState::Queued) {
+        for (auto q = queue_.begin(); q != queue_.end(); ++q) {
+            if (*q == job) {
+                queue_.erase(q);
+                break;
+            }
+        }
+        job->cancel.store(true);
+        job->state = JobState::Cancelled;
+        job->stage = "cancelled";
+        job->task = nullptr;
+        finish(job);
+        return true;
+    }
+    if (job->state == JobState::Running) {
+        job->cancel.store(true);
+        return true;
+    }
+    return false;
+}
+
+void JobQueue::workerLoop() {
+    while (true) {
+        std::shared_ptr<JobRecord> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            if (stopping_) return;
+            job = queue_.front();
+            queue_.pop_front();
+
+            std::lock_guard<std::mutex> jobLock(job->mutex);
+            job->state = JobState::Running;
+            job->stage = "running";
+        }
+
+        JobContext context(job);
+        std::string result;
+        std::string error;
+        bool failed = false;
+        bool cancelled = false;
+        try {
+            result = job->task(context);
+        } catch (const JobCancelled&) {
+            cancelled = true;
+        } catch (const std::exception& ex) {
+            failed = true;
+            error = ex.what();
+        } catch (...) {
+            failed = true;
+            error = "unknown error";
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::lock_guard<std::mutex> jobLock(job->mutex);
+        // поздняя отмена не отменяет уже сохранённый результат: смотрим только на то,
+        // чем закончилась сама задача
+        if (cancelled) {
+            job->state = JobState::Cancelled;
+            job->stage = "cancelled";
+        } else if (failed) {
+            job->state = JobState::Failed;
+            job->error = error;
+            logError("Задача " + job->id + " завершилась с ошибкой: " + error);
+        } else {
+            job->state = JobState::Done;
+            job->stage = "done";
+            job->progress = 1.0;
+            job->resultJson = std::move(result);
+        }
+        job->task = nullptr;
+        finish(job);
+    }
+}
+
+void JobQueue::finish(const std::shared_ptr<JobRecord>& job) {
+    finished_.push_back(job->id);
+    while (finished_.size() > keepFinished_) {
+        jobs_.erase(finished_.front());
+        finished_.pop_front();
+    }
+}
@@ -0,0 +1,101 @@
+// job_queue.h — ограниченная очередь фоновых задач со своим пулом потоков
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+enum class JobState {
+    Queued,
+    Running,
+    Done,
+    Failed,
+    Cancelled
+};
+
+// "queued" / "running" / "done" / "failed" / "cancelled"
+const char* jobStateName(JobState state);
+
+// Снимок состояния задачи для ответа клиенту
+struct JobInfo {
+    std::string id;
+    long ownerId;
+    JobState state;
+    double progress;        // 0..1
+    std::string stage;      // текущий этап, который сообщила задача
+    std::string resultJson; // только для Done
+    std::string error;      // только для Failed
+};
+
+struct JobRecord;
+
+// Задача остановилась по отмене, ничего не сохранив: бросается из задачи,
+// задача переходит в Cancelled. Задача, вернувшая результат, всегда Done —
+// даже если отмену попросили, когда результат уже был сохранён
+class JobCancelled : public std::runtime_error {
+public:
+    JobCancelled() : std::runtime_error("cancelled") {}
+};
+
+// То, что задача видит о себе: кооперативная отмена и отчёт о ходе работы
+class JobContext {
+public:
+    explicit JobContext(std::shared_ptr<JobRecord> job) : job_(std::move(job)) {}
+
+    // Флаг для GeneratorOptions::cancel и т.п.; живёт, пока жива задача
+    const std::atomic<bool>* cancelFlag() const;
+    bool cancelled() const;
+    void setProgress(const std::string& stage, double progress);
+
+private:
+    std::shared_ptr<JobRecord> job_;
+};
+
+class JobQueue {
+public:
+    // Возвращает JSON результата; исключение — задача Failed
+    using Task = std::function<std::string(JobContext&)>;
+
+    // keepFinished — сколько завершённых задач помнить для опроса статуса
+    JobQueue(int workerCount, std::size_t capacity, std::size_t keepFinished = 256);
+    ~JobQueue();
+
+    JobQueue(const JobQueue&) = delete;
+    JobQueue& operator=(const JobQueue&) = delete;
+
+    // id новой задачи или nullopt, если в очереди уже capacity ожидающих
+    std::optional<std::string> submit(long ownerId, Task task);
+
+    std::optional<JobInfo> find(const std::string& id) const;
+
+    // Ожидающая задача снимается сразу, выполняющейся выставляется флаг отмены
+    // (она станет Cancelled, только если остановится до сохранения результата).
+    // false — задачи нет или она уже завершилась
+    bool cancel(const std::string& id);
+
+private:
+    void workerLoop();
+    void finish(const std::shared_ptr<JobRecord>& job); // под mutex_
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::shared_ptr<JobRecord>> queue_;
+    std::unordered_map<std::string, std::shared_ptr<JobRecord>> jobs_;
+    std::deque<std::string> finished_; // в порядке завершения, старые вытесняются
+    std::size_t capacity_;
+    std::size_t keepFinished_;
+    bool stopping_ = false;
+    unsigned long long nextSeq_ = 0;
+    unsigned long long idSalt_;
+    std::vector<std::thread> workers_;
+};
@@ -1,16 +1,19 @@
 #include "logger.h"
 #include <fstream>
 #include <iostream>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <ctime>
+#include <memory>
 #include <mutex>
+#include <thread>
 
 namespace {
-    std::ofstream logFile;
-    std::mutex logMutex;
-    bool initialized = false;
-
-    std::string levelToString(LogLevel level) {
+    const char* levelToString(LogLevel level) {
         switch (level) {
             case LogLevel::Info:    return "INFO";
             case LogLevel::Warning: return "WARN";
@@ -20,16 +23,13 @@ namespace {
         return "UNKNOWN";
     }
 
-    std::string currentTimeString() {
-        using namespace std::chrono;
-        auto now = system_clock::now();
-        std::time_t t = system_clock::to_time_t(now);
+    std::string timeString(std::time_t t) {
         std::tm tm{};
     #if defined(_WIN32) || defined(_WIN64)
-        localtime_s(&tm, &t); 
+        localtime_s(&tm, &t);
 
     #else
-        localtime_r(&t, &tm);   
+        localtime_r(&t, &tm);
 
     #endif
         char buf[32];
@@ -37,33 +37,282 @@ namespace {
         return std::string(buf);
     }
 
-    void ensureInitialized() {
-        if (!initialized) {
-            logFile.open("log.txt", std::ios::out | std::ios::app);
-            initialized = true;
+    int levelFromEnv() {
+        const char* v = std::getenv("KURSACH_LOG_LEVEL");
+        if (!v) return logSeverity(LogLevel::Info);
+        std::string name(v);
+        if (name == "debug") return logSeverity(LogLevel::Debug);
+        if (name == "warn" || name == "warning") return logSeverity(LogLevel::Warning);
+        if (name == "error") return logSeverity(LogLevel::Error);
+        return logSeverity(LogLevel::Info);
+    }
+
+    int envInt(const char* name, int fallback) {
+        const char* v = std::getenv(name);
+        if (!v || !*v) return fallback;
+        int x = std::atoi(v);
+        return x > 0 ? x : fallback;
+    }
+
+    struct Entry {
+        LogLevel level;
+        std::time_t time;
+        std::string msg;
+    };
+
+    // Ограниченная очередь многих писателей и одного читателя (схема Вьюкова):
+    // у каждой ячейки номер хода; писатель занимает позицию CAS-ом по tail_,
+    // читатель — единственный, ему хватает обычного head_
+    class LogRing {
+    public:
+        explicit LogRing(size_t capacity) {
+            size_t cap = 2;
+            while (cap < capacity) cap <<= 1;
+            mask_ = cap - 1;
+            cells_.reset(new Cell[cap]);
+            for (size_t i = 0; i < cap; ++i) cells_[i].seq.store(i, std::memory_order_relaxed);
+        }
+
+        bool tryPush(Entry& e) {
+            size_t pos = tail_.load(std::memory_order_relaxed);
+            Cell* cell;
+            while (true) {
+                cell = &cells_[pos & mask_];
+                size_t seq = cell->seq.load(std::memory_order_acquire);
+                intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+                if (diff == 0) {
+                    if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+                } else if (diff < 0) {
+                    return false; // полон
+                } else {
+                    pos = tail_.load(std::memory_order_relaxed);
+                }
+            }
+            cell->entry = std::move(e);
+            cell->seq.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        // только поток записи
+        bool tryPop(Entry& out) {
+            Cell& cell = cells_[head_ & mask_];
+            size_t seq = cell.seq.load(std::memory_order_acquire);
+            if ((intptr_t)seq - (intptr_t)(head_ + 1) < 0) return false;
+            out = std::move(cell.entry);
+            cell.seq.store(head_ + mask_ + 1, std::memory_order_release);
+            ++head_;
+            return true;
+        }
+
+        size_t capacity() const { return mask_ + 1; }
+        // приблизительно: для решения, будить ли поток записи
+        size_t approxSize() const {
+            size_t t = tail_.load(std::memory_order_relaxed);
+            size_t h = consumed_.load(std::memory_order_relaxed);
+            return t > h ? t - h : 0;
+        }
+        size_t pushed() const { return tail_.load(std::memory_order_acquire); }
+        void markConsumed() { consumed_.store(head_, std::memory_order_release); }
+        size_t consumed() const { return consumed_.load(std::memory_order_acquire); }
+
+    private:
+        struct Cell {
+            std::atomic<size_t> seq;
+            Entry entry;
+        };
+
+        std::unique_ptr<Cell[]> cells_;
+        size_t mask_ = 0;
+        alignas(64) std::atomic<size_t> tail_{0};
+        alignas(64) size_t head_ = 0;
+        std::atomic<size_t> consumed_{0}; // head_ после записи пачки
+    };
+
+    class AsyncLogger {
+    public:
+        AsyncLogger()
+            : ring_(envInt("KURSACH_LOG_QUEUE", 8192)),
+              flushInterval_(std::chrono::milliseconds(envInt("KURSACH_LOG_FLUSH_MS", 200))) {
+            const char* overflow = std::getenv("KURSACH_LOG_OVERFLOW");
+            blockAll_ = overflow && std::strcmp(overflow, "block") == 0;
+            file_.open("log.txt", std::ios::out | std::ios::app);
+            writer_ = std::thread([this] { run(); });
+        }
+
+        ~AsyncLogger() {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+            cv_.notify_all();
+            writer_.join();
+        }
+
+        void push(LogLevel level, std::string msg) {
+            Entry e{level, std::time(nullptr), std::move(msg)};
+
+            if (!ring_.tryPush(e)) {
+                bool mayDrop = !blockAll_ && (level == LogLevel::Info || level == LogLevel::Debug);
+                if (mayDrop) {
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                // ждём, пока поток записи освободит место
+                blocked_.fetch_add(1, std::memory_order_relaxed);
+                do {
+                    cv_.notify_one();
+                    std::this_thread::yield();
+                } while (!ring_.tryPush(e));
+            }
+
+            if (level == LogLevel::Error || ring_.approxSize() * 2 >= ring_.capacity()) {
+                cv_.notify_one();
+            }
+        }
+
+        void flush() {
+            size_t target = ring_.pushed();
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (ring_.consumed() < target && !stopping_) {
+                // запись могла быть ещё не опубликована писателем — просим снова
+                flushRequested_ = true;
+                cv_.notify_one();
+                flushedCv_.wait_for(lock, flushInterval_);
+            }
         }
+
+        LoggerStats stats() const {
+            LoggerStats s;
+            s.written = written_.load(std::memory_order_relaxed);
+            s.dropped = dropped_.load(std::memory_order_relaxed);
+            s.blocked = blocked_.load(std::memory_order_relaxed);
+            return s;
+        }
+
+    private:
+        void run() {
+            std::string batch;
+            Entry e;
+            std::time_t cachedTime = -1;
+            std::string cachedTimeStr;
+            unsigned long long reportedDrops = 0;
+            auto lastFlush = std::chrono::steady_clock::now();
+
+            while (true) {
+                bool sawError = false;
+                size_t count = 0;
+                batch.clear();
+
+                unsigned long long drops = dropped_.load(std::memory_order_relaxed);
+                if (drops != reportedDrops) {
+                    batch += "[" + timeString(std::time(nullptr)) + "][WARN] Логгер: буфер переполнен, отброшено сообщений: " +
+                             std::to_string(drops - reportedDrops) + "\n";
+                    reportedDrops = drops;
+                }
+
+                while (ring_.tryPop(e)) {
+                    // время форматируем раз в секунду, а не на каждое сообщение
+                    if (e.time != cachedTime) {
+                        cachedTime = e.time;
+                        cachedTimeStr = timeString(e.time);
+                    }
+                    batch += '[';
+                    batch += cachedTimeStr;
+                    batch += "][";
+                    batch += levelToString(e.level);
+                    batch += "] ";
+                    batch += e.msg;
+                    batch += '\n';
+                    if (e.level == LogLevel::Error) sawError = true;
+                    ++count;
+                }
+
+                if (!batch.empty()) {
+                    if (file_.is_open()) file_.write(batch.data(), batch.size());
+                    // ВСЁ: в консоль только через stderr, stdout не трогаем
+                    std::cerr.write(batch.data(), batch.size());
+                    written_.fetch_add(count, std::memory_order_relaxed);
+                }
+
+                auto now = std::chrono::steady_clock::now();
+                bool flushNow = sawError || now - lastFlush >= flushInterval_;
+
+                std::unique_lock<std::mutex> lock(mutex_);
+                if (flushRequested_) flushNow = true;
+                if (flushNow && file_.is_open()) {
+                    file_.flush();
+                    lastFlush = now;
+                }
+                ring_.markConsumed();
+                if (flushNow) {
+                    flushRequested_ = false;
+                    flushedCv_.notify_all();
+                }
+
+                if (count > 0) continue;
+                if (stopping_) break;
+                cv_.wait_for(lock, flushInterval_);
+            }
+
+            if (file_.is_open()) file_.flush();
+            flushedCv_.notify_all();
+        }
+
+        LogRing ring_;
+        std::chrono::milliseconds flushInterval_;
+        bool blockAll_ = false;
+        std::ofstream file_;
+
+        std::atomic<unsigned long long> written_{0};
+        std::atomic<unsigned long long> dropped_{0};
+        std::atomic<unsigned long long> blocked_{0};
+
+        std::mutex mutex_;
+        std::condition_variable cv_;        // будит поток записи
+        std::condition_variable flushedCv_; // ждущим flush()
+        bool flushRequested_ = false;
+        bool stopping_ = false;
+        std::thread writer_;
+    };
+
+    // Создаётся при первой записи; при выходе из программы дописывает очередь
+    AsyncLogger& logger() {
+        static AsyncLogger instance;
+        return instance;
     }
 }
 
-void logMessage(LogLevel level, const std::string& msg) {
-    std::lock_guard<std::mutex> lock(logMutex);
-    ensureInitialized();
-
-    std::string timeStr  = currentTimeString();
-    std::string levelStr = levelToString(level);
+namespace logdetail {
+std::atomic<int> minSeverity{levelFromEnv()};
+}
 
-    std::string full = "[" + timeStr + "][" + levelStr + "] " + msg + "\n";
+void setLogLevel(LogLevel level) {
+    logdetail::minSeverity.store(logSeverity(level), std::memory_order_relaxed);
+}
 
-    if (logFile.is_open()) {
-        logFile << full;
-        logFile.flush();
+LogLevel logLevel() {
+    switch (logdetail::minSeverity.load(std::memory_order_relaxed)) {
+        case 0: return LogLevel::Debug;
+        case 1: return LogLevel::Info;
+        case 2: return LogLevel::Warning;
     }
+    return LogLevel::Error;
+}
+
+void logMessage(LogLevel level, std::string msg) {
+    if (!logEnabled(level)) return;
+    logger().push(level, std::move(msg));
+}
+
+void logInfo(std::string msg)    { logMessage(LogLevel::Info, std::move(msg)); }
+void logWarning(std::string msg) { logMessage(LogLevel::Warning, std::move(msg)); }
+void logError(std::string msg)   { logMessage(LogLevel::Error, std::move(msg)); }
+void logDebug(std::string msg)   { logMessage(LogLevel::Debug, std::move(msg)); }
 
-    // ВСЁ: в консоль только через stderr, stdout не трогаем
-    std::cerr << full;
+LoggerStats loggerStats() {
+    return logger().stats();
 }
 
-void logInfo(const std::string& msg)    { logMessage(LogLevel::Info, msg); }
-void logWarning(const std::string& msg) { logMessage(LogLevel::Warning, msg); }
-void logError(const std::string& msg)   { logMessage(LogLevel::Error, msg); }
-void logDebug(const std::string& msg)   { logMessage(LogLevel::Debug, msg); }
+void flushLog() {
+    logger().flush();
+}
@@ -1,3 +1,4 @@
+#include <atomic>
 #include <string>
 
 #pragma once
@@ -9,9 +10,79 @@ enum class LogLevel {
     Debug
 };
 
-void logMessage(LogLevel level, const std::string& msg);
+// Важность уровня: Debug < Info < Warning < Error (порядок в enum исторический)
+constexpr int logSeverity(LogLevel level) {
+    switch (level) {
+        case LogLevel::Debug:   return 0;
+        case LogLevel::Info:    return 1;
+        case LogLevel::Warning: return 2;
+        case LogLevel::Error:   return 3;
+    }
+    return 3;
+}
 
-void logInfo(const std::string& msg);
-void logWarning(const std::string& msg);
-void logError(const std::string& msg);
-void logDebug(const std::string& msg);
+// Нижний уровень, который вообще попадает в сборку: вызовы LOG_* ниже него
+// вырезаются компилятором вместе с построением сообщения. По умолчанию
+// в release (NDEBUG) вырезается Debug; задаётся -DKURSACH_LOG_COMPILED_MIN=<важность>
+#ifndef KURSACH_LOG_COMPILED_MIN
+#  ifdef NDEBUG
+#    define KURSACH_LOG_COMPILED_MIN 1
+#  else
+#    define KURSACH_LOG_COMPILED_MIN 0
+#  endif
+#endif
+
+namespace logdetail {
+// Текущий нижний уровень (важность); из KURSACH_LOG_LEVEL при старте
+extern std::atomic<int> minSeverity;
+}
+
+// Будет ли записано сообщение этого уровня
+inline bool logEnabled(LogLevel level) {
+    return logSeverity(level) >= KURSACH_LOG_COMPILED_MIN &&
+           logSeverity(level) >= logdetail::minSeverity.load(std::memory_order_relaxed);
+}
+
+// Нижний уровень во время работы. KURSACH_LOG_LEVEL: debug / info (по умолчанию) / warn / error
+void setLogLevel(LogLevel level);
+LogLevel logLevel();
+
+// Запись асинхронная: сообщение кладётся в кольцевой буфер (без блокировок),
+// в log.txt и stderr его пишет отдельный поток пачками. Файл сбрасывается на диск
+// раз в интервал и сразу после Error.
+// Настройки из окружения (читаются при первой записи):
+//   KURSACH_LOG_QUEUE     — мест в буфере (по умолчанию 8192, округляется до степени двойки)
+//   KURSACH_LOG_OVERFLOW  — "drop" (по умолчанию): при переполнении Info/Debug
+//                           отбрасываются, Warning/Error ждут места; "block" — ждут все
+//   KURSACH_LOG_FLUSH_MS  — интервал сброса файла (по умолчанию 200)
+void logMessage(LogLevel level, std::string msg);
+
+// Сообщение строится до вызова — в циклах и на частых путях лучше LOG_*
+void logInfo(std::string msg);
+void logWarning(std::string msg);
+void logError(std::string msg);
+void logDebug(std::string msg);
+
+// Сообщение вычисляется, только если уровень включён:
+//   LOG_DEBUG("Назначаем exam id=" + std::to_string(exam.id));
+#define KURSACH_LOG(level, msg)                                      \
+    do {                                                             \
+        if (logEnabled(level)) logMessage((level), (msg));           \
+    } while (0)
+
+#define LOG_DEBUG(msg) KURSACH_LOG(LogLevel::Debug, msg)
+#define LOG_INFO(msg)  KURSACH_LOG(LogLevel::Info, msg)
+#define LOG_WARN(msg)  KURSACH_LOG(LogLevel::Warning, msg)
+#define LOG_ERROR(msg) KURSACH_LOG(LogLevel::Error, msg)
+
+// Счётчики логгера с момента запуска
+struct LoggerStats {
+    unsigned long long written = 0; // записано сообщений
+    unsigned long long dropped = 0; // отброшено при переполнении буфера
+    unsigned long long blocked = 0; // сообщений, которым пришлось ждать места
+};
+
+LoggerStats loggerStats();
+
+// Дождаться, пока всё, что уже поставлено в очередь, будет записано и сброшено на диск
+void flushLog();
@@ -0,0 +1,149 @@
+// multistart.cpp
+#include "multistart.h"
+
+#include "graph.h"
+#include "instance_index.h"
+#include "logger.h"
+#include "schedule_cost.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// seed варианта k (k >= 1); никогда не 0 — 0 означает базовый вариант
+static unsigned variantSeed(unsigned baseSeed, int k) {
+    unsigned s = baseSeed * 2654435761u + (unsigned)k * 40503u + 1u;
+    return s == 0 ? 1u : s;
+}
+
+// true, если a лучше b
+static bool isBetter(const ScheduleCandidate& a, const ScheduleCandidate& b) {
+    if (a.validation.errorCount() != b.validation.errorCount()) {
+        return a.validation.errorCount() < b.validation.errorCount();
+    }
+    return a.softCost < b.softCost;
+}
+
+ScheduleCandidate generateScheduleMultiStart(
+    const std::vector<Exam>& exams,
+    const InstanceIndex& index,
+    int maxExamsPerDayForGroup,
+    const std::string& sessionStartDate,
+    const std::string& sessionEndDate,
+    const MultiStartOptions& options
+) {
+    using Clock = std::chrono::steady_clock;
+    auto deadline = Clock::now() + std::chrono::milliseconds(std::max(0, options.timeBudgetMs));
+
+    int variants = std::max(1, options.variants);
+    int threadCount = options.threads > 0
+        ? options.threads
+        : (int)std::max(1u, std::thread::hardware_concurrency());
+    threadCount = std::min(threadCount, variants);
+
+    LOG_INFO("=== Мультистарт: вариантов=" + std::to_string(variants) +
+             ", потоков=" + std::to_string(threadCount) +
+             ", бюджет=" + std::to_string(options.timeBudgetMs) + " мс ===");
+
+    // граф конфликтов один на все варианты, потоки его только читают;
+    // плотная матрица — только для жадной раскраски
+    CsrConflictGraph csr = buildCsrConflictGraph(exams);
+    bool needDense = options.base.coloring == ColoringAlgorithm::Greedy;
+    ConflictGraph graph = needDense ? buildConflictGraph(csr) : ConflictGraph(0);
+
+    // Сторож: по истечении бюджета (или при внешней отмене) выставляет stop —
+    // уже идущие варианты прерываются генератором и отбрасываются
+    std::atomic<bool> stop{false};
+    std::mutex watchMutex;
+    std::condition_variable watchCv;
+    bool finished = false;
+    std::thread watchdog([&] {
+        std::unique_lock<std::mutex> lock(watchMutex);
+        while (!finished) {
+            if (Clock::now() >= deadline ||
+                (options.base.cancel && options.base.cancel->load(std::memory_order_relaxed))) {
+                stop.store(true);
+                return;
+            }
+            watchCv.wait_until(lock, std::min(deadline, Clock::now() + std::chrono::milliseconds(20)));
+        }
+    });
+
+    std::atomic<int> nextVariant{0};
+    std::mutex bestMutex;
+    ScheduleCandidate best;
+    bool haveBest = false;
+    int tried = 0;
+    int dropped = 0;
+
+    auto worker = [&]() {
+        while (true) {
+            int k = nextVariant.fetch_add(1);
+            if (k >= variants) break;
+            // базовый вариант считаем всегда (его прерывает только внешняя отмена),
+            // остальные — пока не вышел бюджет
+            if (k > 0 && stop.load()) break;
+            if (options.base.cancel && options.base.cancel->load(std::memory_order_relaxed)) break;
+
+            ScheduleCandidate cand;
+            GeneratorOptions genOptions = options.base;
+            genOptions.shuffleSeed = (k == 0) ? 0u : variantSeed(options.base.seed, k);
+            genOptions.csr = &csr;
+            genOptions.graph = needDense ? &graph : nullptr;
+            bool interrupted = false;
+            if (k > 0) genOptions.cancel = &stop;
+            genOptions.interrupted = &interrupted;
+            cand.shuffleSeed = genOptions.shuffleSeed;
+
+            cand.assignments = generateSchedule(exams, index, maxExamsPerDayForGroup, genOptions);
+
+            // вариант, прерванный на середине, неполон — не сравниваем его;
+            // успевший завершиться до stop сравнивается как обычно
+            if (k > 0 && interrupted) {
+                std::lock_guard<std::mutex> lock(bestMutex);
+                ++dropped;
+                break;
+            }
+
+            ScheduleValidator validator;
+            cand.validation = validator.checkAll(
+                exams, index, cand.assignments,
+                sessionStartDate, sessionEndDate, maxExamsPerDayForGroup
+            );
+            cand.softCost = computeSoftCost(exams, index, cand.assignments);
+
+            LOG_INFO("Мультистарт: вариант " + std::to_string(k) +
+                     " ошибок=" + std::to_string(cand.validation.errorCount()) +
+                     " мягкая_стоимость=" + std::to_string(cand.softCost));
+
+            std::lock_guard<std::mutex> lock(bestMutex);
+            ++tried;
+            if (!haveBest || isBetter(cand, best)) {
+                best = std::move(cand);
+                haveBest = true;
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threadCount; ++t) pool.emplace_back(worker);
+    worker();
+    for (std::thread& th : pool) th.join();
+
+    {
+        std::lock_guard<std::mutex> lock(watchMutex);
+        finished = true;
+    }
+    watchCv.notify_all();
+    watchdog.join();
+
+    best.variantsTried = tried;
+    LOG_INFO("Мультистарт: лучший вариант shuffleSeed=" + std::to_string(best.shuffleSeed) +
+             " ошибок=" + std::to_string(best.validation.errorCount()) +
+             " из " + std::to_string(tried) + " вариантов" +
+             (dropped ? ", прервано по бюджету " + std::to_string(dropped) : std::string()));
+    return best;
+}
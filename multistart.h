@@ -0,0 +1,39 @@
+// multistart.h — параллельный мультистарт графового генератора
+#pragma once
+
+#include <string>
+#include <vector>
+#include "model.h"
+#include "generator.h"
+#include "validator.h"
+
+class InstanceIndex;
+
+struct MultiStartOptions {
+    int variants = 1;          // сколько вариантов генератора запустить (1 — обычный запуск)
+    int threads = 0;           // число потоков, 0 — по числу ядер
+    int timeBudgetMs = 2000;   // по истечении бюджета идущие варианты прерываются и отбрасываются
+    GeneratorOptions base;     // алгоритм раскраски и seed
+};
+
+struct ScheduleCandidate {
+    std::vector<ExamAssignment> assignments;
+    ValidationResult validation;
+    double softCost = 0.0;
+    unsigned shuffleSeed = 0;  // 0 — базовый (неперемешанный) вариант
+    int variantsTried = 0;     // сколько вариантов успели посчитать
+};
+
+// Запускает до options.variants вариантов generateSchedule параллельно (вариант 0 —
+// базовый, остальные с разными shuffleSeed), проверяет каждый ScheduleValidator'ом
+// и возвращает лучший: меньше ошибок валидации, затем меньше мягкая стоимость.
+// Базовый вариант досчитывается всегда, остальные укладываются в timeBudgetMs.
+// Граф конфликтов строится один раз и общий для всех вариантов.
+ScheduleCandidate generateScheduleMultiStart(
+    const std::vector<Exam>& exams,
+    const InstanceIndex& index,
+    int maxExamsPerDayForGroup,
+    const std::string& sessionStartDate,
+    const std::string& sessionEndDate,
+    const MultiStartOptions& options
+);
@@ -235,6 +235,32 @@ useEffect(() => {
     setUser(null);
   };
 
+  // --- опрос фоновой генерации: result задачи или null (ошибка уже показана) ---
+  const waitForScheduleJob = async (jobId) => {
+    while (true) {
+      await new Promise((resolve) => setTimeout(resolve, 500));
+
+      const res = await fetch(`/api/schedule/jobs/${jobId}`, {
+        credentials: "include",
+      });
+      if (!res.ok) {
+        setErrorMsg(`Ошибка HTTP ${res.status} при опросе задачи генерации`);
+        return null;
+      }
+
+      const job = await res.json();
+      if (job.status === "done") return job.result;
+      if (job.status === "failed") {
+        setErrorMsg(`Ошибка генерации: ${job.error || "неизвестная ошибка"}`);
+        return null;
+      }
+      if (job.status === "cancelled") {
+        setErrorMsg("Генерация отменена");
+        return null;
+      }
+    }
+  };
+
   // --- запрос к C++ серверу: генерация и сохранение расписания ---
   const handleGenerate = async (e) => {
     if (e && e.preventDefault) e.preventDefault();
@@ -290,6 +316,14 @@ useEffect(() => {
       }
 
       const json = await resp.json();
+
+      // 202: генерация поставлена в очередь — опрашиваем задачу до завершения
+      if (resp.status === 202 && json.jobId) {
+        const result = await waitForScheduleJob(json.jobId);
+        if (result) setData(result);
+        return;
+      }
+
       setData(json);
     } catch (e) {
       console.error(e);
@@ -0,0 +1,431 @@
+// optimizer.cpp
+#include "optimizer.h"
+
+#include "graph.h"
+#include "instance_index.h"
+#include "logger.h"
+#include "schedule_cost.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <unordered_map>
+
+namespace {
+
+// Одно жёсткое нарушение весит больше любого реального изменения мягкой стоимости
+constexpr double kHardWeight = 1000.0;
+
+// Цепь Кемпе длиннее этого не трогаем — ход слишком крупный
+constexpr int kMaxKempeChain = 256;
+
+// Текущее расписание и счётчики по (группа, слот), (преподаватель, слот),
+// (аудитория, слот), (группа, день). Снятие/постановка экзамена — O(1)
+// по жёстким нарушениям и O(размер группы) по мягкой стоимости.
+class ScheduleState {
+public:
+    ScheduleState(
+        const std::vector<Exam>& exams,
+        const InstanceIndex& index,
+        int maxExamsPerDayForGroup
+    )
+        : n_(exams.size()),
+          slotCount_(index.timeslots().size()),
+          dayCount_(index.dayCount()),
+          maxPerDay_(maxExamsPerDayForGroup),
+          index_(index),
+          group_(n_), teacher_(n_), size_(n_), difficulty_(n_),
+          slot_(n_, -1), room_(n_, -1),
+          posInSlot_(n_, -1),
+          slotMembers_(slotCount_) {
+        std::unordered_map<int, int> extraGroups, extraTeachers;
+        int groupCount = index.groups().size();
+        int teacherCount = index.teachers().size();
+
+        for (int i = 0; i < n_; ++i) {
+            const Exam& e = exams[i];
+
+            int g = index.groupIndex(e.groupId);
+            if (g < 0) g = extraGroups.emplace(e.groupId, groupCount + (int)extraGroups.size()).first->second;
+            int t = index.teacherIndex(e.teacherId);
+            if (t < 0) t = extraTeachers.emplace(e.teacherId, teacherCount + (int)extraTeachers.size()).first->second;
+
+            const Group* grp = index.findGroup(e.groupId);
+            const Subject* subj = index.findSubject(e.subjectId);
+
+            group_[i] = g;
+            teacher_[i] = t;
+            size_[i] = grp ? grp->peopleCount : 0;
+            difficulty_[i] = subj ? subj->difficulty : 1;
+        }
+
+        int groupKeys = groupCount + extraGroups.size();
+        int teacherKeys = teacherCount + extraTeachers.size();
+        groupMembers_.resize(groupKeys);
+        for (int i = 0; i < n_; ++i) groupMembers_[group_[i]].push_back(i);
+
+        groupSlot_.assign((size_t)groupKeys * slotCount_, 0);
+        teacherSlot_.assign((size_t)teacherKeys * slotCount_, 0);
+        roomSlot_.assign(index.rooms().size() * (size_t)slotCount_, 0);
+        groupDay_.assign((size_t)groupKeys * dayCount_, 0);
+
+        // аудитории по возрастанию вместимости для подбора best fit
+        const std::vector<Room>& rooms = index.rooms();
+        for (int r = 0; r < (int)rooms.size(); ++r) {
+            if (index.roomIndex(rooms[r].id) == r) roomsByCapacity_.push_back(r);
+        }
+        std::stable_sort(roomsByCapacity_.begin(), roomsByCapacity_.end(),
+            [&](int a, int b) { return rooms[a].capacity < rooms[b].capacity; });
+        for (int r : roomsByCapacity_) capacities_.push_back(rooms[r].capacity);
+    }
+
+    int examCount() const { return n_; }
+    int slotCount() const { return slotCount_; }
+    int slotOf(int i) const { return slot_[i]; }
+    int roomOf(int i) const { return room_[i]; }
+    const std::vector<int>& membersOf(int slot) const { return slotMembers_[slot]; }
+
+    int hard() const { return hard_; }
+    double soft() const {
+        return kSoftDifficultyWeight * difficultyCost_ + kSoftSpreadWeight * (double)spreadCost_;
+    }
+    double cost() const { return kHardWeight * hard_ + soft(); }
+
+    // Снять экзамен с его слота и аудитории
+    void remove(int i) {
+        int s = slot_[i];
+        if (s < 0) return;
+        int d = index_.dayOfTimeslot(s);
+
+        hard_ -= roomPenalty(i, room_[i]);
+        if (--groupSlot_[(size_t)group_[i] * slotCount_ + s] >= 1) hard_ -= 1;
+        if (--teacherSlot_[(size_t)teacher_[i] * slotCount_ + s] >= 1) hard_ -= 1;
+        if (room_[i] >= 0 && --roomSlot_[(size_t)room_[i] * slotCount_ + s] >= 1) hard_ -= 1;
+        if (maxPerDay_ > 0 && --groupDay_[(size_t)group_[i] * dayCount_ + d] >= maxPerDay_) hard_ -= 1;
+
+        // слот обнуляется до подсчёта пар, чтобы экзамен не считал сам себя
+        slot_[i] = -1;
+        difficultyCost_ -= difficultyPenalty(difficulty_[i], d, dayCount_);
+        spreadCost_ -= spreadWithGroup(i, d);
+        hard_ += 1; // теперь не назначен
+
+        std::vector<int>& members = slotMembers_[s];
+        int pos = posInSlot_[i];
+        members[pos] = members.back();
+        posInSlot_[members[pos]] = pos;
+        members.pop_back();
+        posInSlot_[i] = -1;
+    }
+
+    // Поставить снятый экзамен в слот s и аудиторию r (r может быть -1)
+    void place(int i, int s, int r) {
+        hard_ -= 1; // был не назначен
+        int d = index_.dayOfTimeslot(s);
+
+        difficultyCost_ += difficultyPenalty(difficulty_[i], d, dayCount_);
+        spreadCost_ += spreadWithGroup(i, d);
+
+        slot_[i] = s;
+        room_[i] = r;
+        hard_ += roomPenalty(i, r);
+        if (++groupSlot_[(size_t)group_[i] * slotCount_ + s] >= 2) hard_ += 1;
+        if (++teacherSlot_[(size_t)teacher_[i] * slotCount_ + s] >= 2) hard_ += 1;
+        if (r >= 0 && ++roomSlot_[(size_t)r * slotCount_ + s] >= 2) hard_ += 1;
+        if (maxPerDay_ > 0 && ++groupDay_[(size_t)group_[i] * dayCount_ + d] > maxPerDay_) hard_ += 1;
+
+        posInSlot_[i] = slotMembers_[s].size();
+        slotMembers_[s].push_back(i);
+    }
+
+    // Изначально все экзамены "не назначены": по 1 нарушению на каждый
+    void resetUnassigned() { hard_ = n_; }
+
+    // Наименьшая свободная в слоте s аудитория, вмещающая экзамен i;
+    // если свободной нет — наименьшая подходящая, если нет и такой — самая большая
+    int pickRoom(int i, int s) const {
+        if (roomsByCapacity_.empty()) return -1;
+        int p = std::lower_bound(capacities_.begin(), capacities_.end(), size_[i]) - capacities_.begin();
+        for (int k = p; k < (int)roomsByCapacity_.size(); ++k) {
+            int r = roomsByCapacity_[k];
+            if (roomSlot_[(size_t)r * slotCount_ + s] == 0) return r;
+        }
+        return p < (int)roomsByCapacity_.size() ? roomsByCapacity_[p] : roomsByCapacity_.back();
+    }
+
+    // Участвует ли экзамен в каком-либо жёстком нарушении
+    bool isConflicted(int i) const {
+        int s = slot_[i];
+        if (s < 0) return true;
+        if (roomPenalty(i, room_[i])) return true;
+        if (groupSlot_[(size_t)group_[i] * slotCount_ + s] > 1) return true;
+        if (teacherSlot_[(size_t)teacher_[i] * slotCount_ + s] > 1) return true;
+        if (room_[i] >= 0 && roomSlot_[(size_t)room_[i] * slotCount_ + s] > 1) return true;
+        int d = index_.dayOfTimeslot(s);
+        return maxPerDay_ > 0 && groupDay_[(size_t)group_[i] * dayCount_ + d] > maxPerDay_;
+    }
+
+    std::vector<int> slots() const { return slot_; }
+    std::vector<int> rooms() const { return room_; }
+
+private:
+    int roomPenalty(int i, int r) const {
+        if (r < 0) return 1; // нет аудитории
+        return index_.rooms()[r].capacity < size_[i] ? 1 : 0;
+    }
+
+    // Штраф за близость экзамена i (в день day) к другим назначенным экзаменам группы
+    long long spreadWithGroup(int i, int day) const {
+        long long sum = 0;
+        for (int j : groupMembers_[group_[i]]) {
+            if (j == i || slot_[j] < 0) continue;
+            sum += spreadPairPenalty(day - index_.dayOfTimeslot(slot_[j]));
+        }
+        return sum;
+    }
+
+    int n_;
+    int slotCount_;
+    int dayCount_;
+    int maxPerDay_;
+    const InstanceIndex& index_;
+
+    std::vector<int> group_, teacher_, size_, difficulty_;
+    std::vector<std::vector<int>> groupMembers_;
+
+    std::vector<int> slot_, room_;
+    std::vector<int> posInSlot_;
+    std::vector<std::vector<int>> slotMembers_;
+
+    std::vector<int> groupSlot_, teacherSlot_, roomSlot_, groupDay_;
+    std::vector<int> roomsByCapacity_;
+    std::vector<int> capacities_;
+
+    int hard_ = 0;
+    double difficultyCost_ = 0.0;
+    long long spreadCost_ = 0;
+};
+
+// Снятое перед ходом положение экзамена — для отката
+struct SavedPlacement {
+    int exam;
+    int slot;
+    int room;
+};
+
+} // namespace
+
+OptimizerResult improveSchedule(
+    const std::vector<Exam>& exams,
+    const InstanceIndex& index,
+    int maxExamsPerDayForGroup,
+    std::vector<ExamAssignment>& assignments,
+    const OptimizerOptions& options
+) {
+    using Clock = std::chrono::steady_clock;
+    auto startTime = Clock::now();
+    auto elapsedMs = [&]() {
+        return std::chrono::duration<double, std::milli>(Clock::now() - startTime).count();
+    };
+
+    OptimizerResult result;
+    int n = exams.size();
+    int slotCount = index.timeslots().size();
+
+    if (n == 0 || slotCount == 0) return result;
+    if ((int)assignments.size() != n) {
+        LOG_WARN("Оптимизатор: пропускаем (экзаменов=" + std::to_string(n) +
+                 ", назначений=" + std::to_string(assignments.size()) +
+                 ", слотов=" + std::to_string(slotCount) + ")");
+        return result;
+    }
+
+    std::mt19937 rng(options.seed);
+    ScheduleState state(exams, index, maxExamsPerDayForGroup);
+    state.resetUnassigned();
+
+    // исходное расписание
+    for (const ExamAssignment& a : assignments) {
+        int i = a.examIndex;
+        if (i < 0 || i >= n || state.slotOf(i) >= 0) continue;
+        int s = index.timeslotIndex(a.timeslotId);
+        if (s < 0) s = std::uniform_int_distribution<int>(0, slotCount - 1)(rng);
+        int r = a.roomId >= 0 ? index.roomIndex(a.roomId) : -1;
+        state.place(i, s, r);
+    }
+    // экзамены без назначения — в случайный слот, дальше их подвинет поиск
+    for (int i = 0; i < n; ++i) {
+        if (state.slotOf(i) >= 0) continue;
+        int s = std::uniform_int_distribution<int>(0, slotCount - 1)(rng);
+        state.place(i, s, state.pickRoom(i, s));
+    }
+
+    result.hardBefore = state.hard();
+    result.softBefore = state.soft();
+    LOG_INFO("Оптимизатор: старт, жёстких нарушений=" + std::to_string(result.hardBefore) +
+             ", мягкая_стоимость=" + std::to_string(result.softBefore) +
+             ", лимит=" + std::to_string(options.timeLimitMs) + " мс");
+
+    CsrConflictGraph graph = buildCsrConflictGraph(exams);
+
+    double bestCost = state.cost();
+    int bestHard = state.hard();
+    double bestSoft = state.soft();
+    std::vector<int> bestSlots = state.slots();
+    std::vector<int> bestRooms = state.rooms();
+
+    std::vector<int> conflicted;
+    std::vector<SavedPlacement> saved;
+    std::vector<int> chain;
+    std::vector<char> inChain(n, 0);
+
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::uniform_int_distribution<int> anyExam(0, n - 1);
+    std::uniform_int_distribution<int> anySlot(0, slotCount - 1);
+
+    double limitMs = std::max(0, options.timeLimitMs);
+    double temperature = options.startTemperature;
+    double lastProgressMs = 0.0;
+    long long iter = 0;
+
+    auto reportProgress = [&](double nowMs) {
+        OptimizerProgress p{iter, state.hard(), bestHard, bestSoft, nowMs, temperature};
+        if (options.onProgress) options.onProgress(p);
+        LOG_DEBUG("Оптимизатор: итераций=" + std::to_string(iter) +
+                  ", жёстких=" + std::to_string(state.hard()) +
+                  ", лучший: жёстких=" + std::to_string(bestHard) +
+                  " мягкая=" + std::to_string(bestSoft) +
+                  ", T=" + std::to_string(temperature));
+    };
+
+    auto revert = [&]() {
+        for (const SavedPlacement& sp : saved) state.remove(sp.exam);
+        for (const SavedPlacement& sp : saved) state.place(sp.exam, sp.slot, sp.room);
+    };
+
+    while (true) {
+        if ((iter & 63) == 0) {
+            double nowMs = elapsedMs();
+            if (nowMs >= limitMs) break;
+            if (options.cancel && options.cancel->load(std::memory_order_relaxed)) break;
+
+            // геометрическое охлаждение по доле израсходованного времени
+            double frac = limitMs > 0 ? nowMs / limitMs : 1.0;
+            temperature = options.startTemperature *
+                std::pow(options.endTemperature / options.startTemperature, frac);
+
+            if (nowMs - lastProgressMs >= options.progressIntervalMs) {
+                lastProgressMs = nowMs;
+                reportProgress(nowMs);
+            }
+        }
+        if ((iter & 1023) == 0) {
+            conflicted.clear();
+            for (int i = 0; i < n; ++i) {
+                if (state.isConflicted(i)) conflicted.push_back(i);
+            }
+        }
+        ++iter;
+
+        // экзамен для хода: чаще — из участвующих в нарушениях
+        int v = (!conflicted.empty() && unit(rng) < 0.7)
+            ? conflicted[std::uniform_int_distribution<int>(0, (int)conflicted.size() - 1)(rng)]
+            : anyExam(rng);
+
+        double before = state.cost();
+        saved.clear();
+
+        double moveKind = unit(rng);
+        int a = state.slotOf(v);
+        int b = anySlot(rng);
+        if (b == a) continue;
+
+        if (moveKind < 0.6) {
+            // 1) перенос одного экзамена в слот b
+            saved.push_back({v, a, state.roomOf(v)});
+            state.remove(v);
+            state.place(v, b, state.pickRoom(v, b));
+        } else if (moveKind < 0.9) {
+            // 2) цепь Кемпе: компонента v в подграфе экзаменов слотов a и b меняет слоты
+            chain.clear();
+            chain.push_back(v);
+            inChain[v] = 1;
+            bool tooLong = false;
+            for (size_t k = 0; k < chain.size() && !tooLong; ++k) {
+                int u = chain[k];
+                for (const int* it = graph.begin(u); it != graph.end(u); ++it) {
+                    int w = *it;
+                    if (inChain[w]) continue;
+                    int sw = state.slotOf(w);
+                    if (sw != a && sw != b) continue;
+                    inChain[w] = 1;
+                    chain.push_back(w);
+                    if ((int)chain.size() > kMaxKempeChain) {
+                        tooLong = true;
+                        break;
+                    }
+                }
+            }
+            for (int u : chain) inChain[u] = 0;
+            if (tooLong) continue;
+
+            for (int u : chain) saved.push_back({u, state.slotOf(u), state.roomOf(u)});
+            for (int u : chain) state.remove(u);
+            for (const SavedPlacement& sp : saved) {
+                int target = (sp.slot == a) ? b : a;
+                state.place(sp.exam, target, state.pickRoom(sp.exam, target));
+            }
+        } else {
+            // 3) обмен содержимого слотов a и b целиком (аудитории сохраняются)
+            for (int u : state.membersOf(a)) saved.push_back({u, a, state.roomOf(u)});
+            for (int u : state.membersOf(b)) saved.push_back({u, b, state.roomOf(u)});
+            if (saved.empty()) continue;
+            for (const SavedPlacement& sp : saved) state.remove(sp.exam);
+            for (const SavedPlacement& sp : saved) {
+                state.place(sp.exam, sp.slot == a ? b : a, sp.room);
+            }
+        }
+
+        double delta = state.cost() - before;
+        bool accept = delta <= 0.0 ||
+            (temperature > 0.0 && unit(rng) < std::exp(-delta / temperature));
+
+        if (!accept) {
+            revert();
+            continue;
+        }
+        ++result.acceptedMoves;
+
+        if (state.cost() < bestCost - 1e-9) {
+            bestCost = state.cost();
+            bestHard = state.hard();
+            bestSoft = state.soft();
+            bestSlots = state.slots();
+            bestRooms = state.rooms();
+        }
+    }
+
+    // записываем лучшее найденное расписание
+    const std::vector<Timeslot>& timeslots = index.timeslots();
+    const std::vector<Room>& rooms = index.rooms();
+    for (ExamAssignment& a : assignments) {
+        int i = a.examIndex;
+        if (i < 0 || i >= n) continue;
+        a.timeslotId = timeslots[bestSlots[i]].id;
+        a.roomId = bestRooms[i] >= 0 ? rooms[bestRooms[i]].id : -1;
+    }
+
+    result.hardAfter = bestHard;
+    result.softAfter = bestSoft;
+    result.iterations = iter;
+    result.elapsedMs = elapsedMs();
+    reportProgress(result.elapsedMs);
+
+    LOG_INFO("Оптимизатор: готово за " + std::to_string((long long)result.elapsedMs) + " мс, итераций=" +
+             std::to_string(result.iterations) +
+             ", жёстких нарушений " + std::to_string(result.hardBefore) +
+             " -> " + std::to_string(result.hardAfter) +
+             ", мягкая_стоимость " + std::to_string(result.softBefore) +
+             " -> " + std::to_string(result.softAfter));
+    return result;
+}
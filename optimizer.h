@@ -0,0 +1,52 @@
+// optimizer.h — локальный поиск (имитация отжига) поверх результата генератора
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <vector>
+#include "model.h"
+
+class InstanceIndex;
+
+// Состояние поиска для отчёта о ходе работы
+struct OptimizerProgress {
+    long long iterations;
+    int hardViolations;   // текущие жёсткие нарушения (конфликты, аудитории, maxPerDay)
+    int bestHardViolations;
+    double bestSoftCost;
+    double elapsedMs;
+    double temperature;
+};
+
+struct OptimizerOptions {
+    int timeLimitMs = 1000;          // жёсткий лимит времени улучшения
+    unsigned seed = 1;
+    double startTemperature = 5.0;   // температура отжига в начале и в конце
+    double endTemperature = 0.05;
+    int progressIntervalMs = 250;    // как часто вызывать onProgress и писать в лог
+    std::function<void(const OptimizerProgress&)> onProgress; // может быть пустым
+    const std::atomic<bool>* cancel = nullptr; // true — остановиться и вернуть лучшее найденное
+};
+
+struct OptimizerResult {
+    int hardBefore = 0;
+    int hardAfter = 0;
+    double softBefore = 0.0;
+    double softAfter = 0.0;
+    long long iterations = 0;
+    long long acceptedMoves = 0;
+    double elapsedMs = 0.0;
+};
+
+// Улучшает готовое расписание (по одному назначению на экзамен, в порядке exams).
+// Ходы: перенос экзамена в другой слот, обмен по цепи Кемпе между двумя слотами,
+// обмен содержимого двух слотов. Стоимость считается инкрементально: жёсткие
+// нарушения с большим весом плюс мягкая стоимость из schedule_cost.h.
+// Возвращается лучшее найденное расписание (не хуже исходного).
+OptimizerResult improveSchedule(
+    const std::vector<Exam>& exams,
+    const InstanceIndex& index,
+    int maxExamsPerDayForGroup,
+    std::vector<ExamAssignment>& assignments,
+    const OptimizerOptions& options = OptimizerOptions()
+);
@@ -0,0 +1,221 @@
+// reschedule.cpp
+#include "reschedule.h"
+
+#include "instance_index.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+
+// Занятость слотов группами, преподавателями и аудиториями (с учётом слотов,
+// пересекающихся по времени) + счётчики группы по дням
+class Occupancy {
+public:
+    Occupancy(const std::vector<Exam>& exams, const InstanceIndex& index, int maxPerDay)
+        : index_(index),
+          slotCount_(index.timeslots().size()),
+          dayCount_(index.dayCount()),
+          maxPerDay_(maxPerDay),
+          group_(exams.size()), teacher_(exams.size()), size_(exams.size()) {
+        std::unordered_map<int, int> extraGroups, extraTeachers;
+        int groupCount = index.groups().size();
+        int teacherCount = index.teachers().size();
+        for (int i = 0; i < (int)exams.size(); ++i) {
+            const Exam& e = exams[i];
+            int g = index.groupIndex(e.groupId);
+            if (g < 0) g = extraGroups.emplace(e.groupId, groupCount + (int)extraGroups.size()).first->second;
+            int t = index.teacherIndex(e.teacherId);
+            if (t < 0) t = extraTeachers.emplace(e.teacherId, teacherCount + (int)extraTeachers.size()).first->second;
+            const Group* grp = index.findGroup(e.groupId);
+            group_[i] = g;
+            teacher_[i] = t;
+            size_[i] = grp ? grp->peopleCount : 0;
+        }
+        int groupKeys = groupCount + extraGroups.size();
+        int teacherKeys = teacherCount + extraTeachers.size();
+        groupSlot_.assign((size_t)groupKeys * slotCount_, 0);
+        teacherSlot_.assign((size_t)teacherKeys * slotCount_, 0);
+        roomSlot_.assign(index.rooms().size() * (size_t)slotCount_, 0);
+        groupDay_.assign((size_t)groupKeys * dayCount_, 0);
+
+        // аудитории без повторов id, по возрастанию вместимости
+        const std::vector<Room>& rooms = index.rooms();
+        for (int r = 0; r < (int)rooms.size(); ++r) {
+            if (index.roomIndex(rooms[r].id) == r) roomsAsc_.push_back(r);
+        }
+        std::stable_sort(roomsAsc_.begin(), roomsAsc_.end(),
+            [&](int a, int b) { return rooms[a].capacity < rooms[b].capacity; });
+        for (int r : roomsAsc_) capacities_.push_back(rooms[r].capacity);
+    }
+
+    int sizeOf(int exam) const { return size_[exam]; }
+
+    // Можно ли поставить экзамен в слот s без накладок групп/преподавателей и maxPerDay
+    bool slotFree(int exam, int s) const {
+        if (groupSlot_[(size_t)group_[exam] * slotCount_ + s]) return false;
+        if (teacherSlot_[(size_t)teacher_[exam] * slotCount_ + s]) return false;
+        if (maxPerDay_ > 0 &&
+            groupDay_[(size_t)group_[exam] * dayCount_ + index_.dayOfTimeslot(s)] >= maxPerDay_) return false;
+        return true;
+    }
+
+    bool roomFree(int room, int s) const {
+        return roomSlot_[(size_t)room * slotCount_ + s] == 0;
+    }
+
+    // Наименьшая свободная в слоте s аудитория, вмещающая экзамен, или -1
+    int bestFitRoom(int exam, int s) const {
+        int p = std::lower_bound(capacities_.begin(), capacities_.end(), size_[exam]) - capacities_.begin();
+        for (int k = p; k < (int)roomsAsc_.size(); ++k) {
+            if (roomFree(roomsAsc_[k], s)) return roomsAsc_[k];
+        }
+        return -1;
+    }
+
+    // room может быть -1 (экзамен без аудитории). Занятыми становятся слот s
+    // и все слоты, пересекающиеся с ним по времени
+    void place(int exam, int s, int room) {
+        markBusy(exam, s, room);
+        for (int t : index_.overlappingTimeslots(s)) markBusy(exam, t, room);
+        groupDay_[(size_t)group_[exam] * dayCount_ + index_.dayOfTimeslot(s)]++;
+    }
+
+private:
+    void markBusy(int exam, int s, int room) {
+        groupSlot_[(size_t)group_[exam] * slotCount_ + s] = 1;
+        teacherSlot_[(size_t)teacher_[exam] * slotCount_ + s] = 1;
+        if (room >= 0) roomSlot_[(size_t)room * slotCount_ + s] = 1;
+    }
+
+    const InstanceIndex& index_;
+    int slotCount_;
+    int dayCount_;
+    int maxPerDay_;
+
+    std::vector<int> group_, teacher_, size_;
+    std::vector<char> groupSlot_, teacherSlot_, roomSlot_;
+    std::vector<int> groupDay_;
+    std::vector<int> roomsAsc_;
+    std::vector<int> capacities_;
+};
+
+} // namespace
+
+RepairResult repairSchedule(
+    const std::vector<Exam>& exams,
+    const InstanceIndex& index,
+    int maxExamsPerDayForGroup,
+    const std::vector<PreviousPlacement>& previous,
+    const std::vector<int>& touchedExamIds
+) {
+    RepairResult result;
+    const std::vector<Timeslot>& timeslots = index.timeslots();
+    const std::vector<Room>& rooms = index.rooms();
+    int n = exams.size();
+
+    result.assignments.reserve(n);
+    for (int i = 0; i < n; ++i) result.assignments.push_back({i, -1, -1});
+    if (n == 0) return result;
+    if (timeslots.empty()) {
+        LOG_WARN("Перестановка: в config нет слотов, расписание пустое");
+        result.unplaced = n;
+        return result;
+    }
+
+    std::unordered_map<int, const PreviousPlacement*> previousByExam;
+    for (const PreviousPlacement& p : previous) previousByExam.emplace(p.examId, &p);
+    std::unordered_set<int> touched(touchedExamIds.begin(), touchedExamIds.end());
+
+    Occupancy occupancy(exams, index, maxExamsPerDayForGroup);
+
+    // 1) оставляем прежние положения, пока они допустимы
+    std::vector<int> toPlace;
+    std::vector<int> previousSlot(n, -1);
+    for (int i = 0; i < n; ++i) {
+        auto it = previousByExam.find(exams[i].id);
+        const PreviousPlacement* p = (it != previousByExam.end()) ? it->second : nullptr;
+
+        int s = p ? index.timeslotIndex(p->timeslotId) : -1;
+        int r = (p && p->roomId >= 0) ? index.roomIndex(p->roomId) : -1;
+        previousSlot[i] = s;
+
+        bool keep = !touched.count(exams[i].id) &&
+                    s >= 0 && r >= 0 &&
+                    rooms[r].capacity >= occupancy.sizeOf(i) &&
+                    occupancy.slotFree(i, s) &&
+                    occupancy.roomFree(r, s);
+        if (!keep) {
+            toPlace.push_back(i);
+            continue;
+        }
+        occupancy.place(i, s, r);
+        result.assignments[i] = {i, timeslots[s].id, rooms[r].id};
+        ++result.kept;
+    }
+
+    // 2) остальные — крупные группы первыми, каждая в первый подходящий слот
+    std::stable_sort(toPlace.begin(), toPlace.end(),
+        [&](int a, int b) { return occupancy.sizeOf(a) > occupancy.sizeOf(b); });
+
+    std::vector<int> slotOrder(timeslots.size());
+    for (int s = 0; s < (int)timeslots.size(); ++s) slotOrder[s] = s;
+    std::sort(slotOrder.begin(), slotOrder.end(),
+        [&](int a, int b) {
+            if (timeslots[a].date != timeslots[b].date) return timeslots[a].date < timeslots[b].date;
+            return timeslots[a].startMinutes < timeslots[b].startMinutes;
+        }
+    );
+
+    for (int i : toPlace) {
+        int chosenSlot = -1;
+        int chosenRoom = -1;
+
+        auto trySlot = [&](int s) {
+            if (s < 0 || !occupancy.slotFree(i, s)) return false;
+            int r = occupancy.bestFitRoom(i, s);
+            if (r < 0) return false;
+            chosenSlot = s;
+            chosenRoom = r;
+            return true;
+        };
+
+        if (!trySlot(previousSlot[i])) {
+            for (int s : slotOrder) {
+                if (trySlot(s)) break;
+            }
+        }
+
+        if (chosenSlot < 0) {
+            // как и генератор: экзамен остаётся без аудитории, валидатор это покажет
+            chosenSlot = previousSlot[i] >= 0 ? previousSlot[i] : slotOrder.front();
+            ++result.unplaced;
+            LOG_WARN("Перестановка: нет слота с аудиторией для exam id=" + std::to_string(exams[i].id));
+        } else {
+            ++result.placed;
+        }
+
+        occupancy.place(i, chosenSlot, chosenRoom);
+        result.assignments[i] = {i, timeslots[chosenSlot].id, chosenRoom >= 0 ? rooms[chosenRoom].id : -1};
+    }
+
+    // 3) что изменилось относительно сохранённого расписания
+    for (int i = 0; i < n; ++i) {
+        auto it = previousByExam.find(exams[i].id);
+        const ExamAssignment& a = result.assignments[i];
+        if (it == previousByExam.end() ||
+            it->second->timeslotId != a.timeslotId ||
+            it->second->roomId != a.roomId) {
+            result.changedExamIds.push_back(exams[i].id);
+        }
+    }
+
+    LOG_INFO("Перестановка: оставлено=" + std::to_string(result.kept) +
+             ", поставлено заново=" + std::to_string(result.placed) +
+             ", без места=" + std::to_string(result.unplaced) +
+             ", изменилось=" + std::to_string(result.changedExamIds.size()));
+    return result;
+}
@@ -0,0 +1,39 @@
+// reschedule.h — точечная перестановка сохранённого расписания после правки config
+#pragma once
+
+#include <vector>
+#include "model.h"
+
+class InstanceIndex;
+
+// Прежнее положение экзамена, восстановленное из сохранённого результата
+struct PreviousPlacement {
+    int examId;
+    int timeslotId; // -1, если слот не нашёлся в новом config
+    int roomId;     // -1, если аудитория не нашлась
+};
+
+struct RepairResult {
+    std::vector<ExamAssignment> assignments; // по одному на экзамен, в порядке exams
+    std::vector<int> changedExamIds;         // id экзаменов, у которых изменились слот или аудитория
+    int kept = 0;      // оставлены на прежнем месте
+    int placed = 0;    // поставлены заново без нарушений
+    int unplaced = 0;  // не нашлось слота с аудиторией без нарушений
+};
+
+// Оставляет на месте все экзамены, которых правка не коснулась и чьё положение
+// по-прежнему допустимо, и заново ставит только:
+//  - экзамены из touchedExamIds и новые (без прежнего положения);
+//  - экзамены, чьё положение стало недопустимым: слот или аудитория удалены,
+//    аудитория мала для группы, накладка с другим оставленным экзаменом,
+//    превышен maxExamsPerDayForGroup.
+// Граф конфликтов не строится: занятость групп, преподавателей и аудиторий
+// ведётся плоскими таблицами по слотам, проверка слота для экзамена — O(1).
+// Новое место ищется сначала в прежнем слоте экзамена, затем по порядку слотов.
+RepairResult repairSchedule(
+    const std::vector<Exam>& exams,
+    const InstanceIndex& index,
+    int maxExamsPerDayForGroup,
+    const std::vector<PreviousPlacement>& previous,
+    const std::vector<int>& touchedExamIds
+);
@@ -0,0 +1,114 @@
+// response_cache.cpp
+#include "response_cache.h"
+
+#include "compression.h"
+
+#include <cstdint>
+#include <cstdio>
+
+static std::uint64_t fnv1a64(const std::string& data) {
+    std::uint64_t h = 1469598103934665603ULL;
+    for (unsigned char c : data) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+std::string contentEtag(const std::string& body) {
+    char buf[24];
+    std::snprintf(buf, sizeof(buf), "\"%016llx\"", (unsigned long long)fnv1a64(body));
+    return buf;
+}
+
+std::string scheduleEtag(long scheduleId, const std::string& updatedAt) {
+    char buf[48];
+    std::snprintf(buf, sizeof(buf), "\"s%ld-%016llx\"", scheduleId, (unsigned long long)fnv1a64(updatedAt));
+    return buf;
+}
+
+void precompress(CachedResponse& response, std::size_t minBytes) {
+    if (response.body.size() < minBytes) {
+        return;
+    }
+    response.gzipBody = gzipCompress(response.body);
+    response.brotliBody = brotliCompress(response.body);
+}
+
+bool etagMatches(const std::string& ifNoneMatch, const std::string& etag) {
+    // список через запятую; слабые W/"..." сравниваем по самому тегу
+    std::size_t pos = 0;
+    while (pos < ifNoneMatch.size()) {
+        std::size_t end = ifNoneMatch.find(',', pos);
+        if (end == std::string::npos) end = ifNoneMatch.size();
+
+        std::size_t b = pos, e = end;
+        while (b < e && (ifNoneMatch[b] == ' ' || ifNoneMatch[b] == '\t')) ++b;
+        while (e > b && (ifNoneMatch[e - 1] == ' ' || ifNoneMatch[e - 1] == '\t')) --e;
+        if (e - b >= 2 && ifNoneMatch.compare(b, 2, "W/") == 0) b += 2;
+
+        if (ifNoneMatch.compare(b, e - b, "*") == 0 ||
+            ifNoneMatch.compare(b, e - b, etag) == 0) {
+            return true;
+        }
+        pos = end + 1;
+    }
+    return false;
+}
+
+std::shared_ptr<const CachedResponse> ResponseCache::get() const {
+    return std::atomic_load(&value_);
+}
+
+unsigned long long ResponseCache::generation() const {
+    return generation_.load(std::memory_order_acquire);
+}
+
+bool ResponseCache::put(unsigned long long seenGeneration, std::shared_ptr<const CachedResponse> response) {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    if (generation_.load(std::memory_order_relaxed) != seenGeneration) {
+        return false;
+    }
+    std::atomic_store(&value_, std::move(response));
+    return true;
+}
+
+void ResponseCache::invalidate() {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    generation_.fetch_add(1, std::memory_order_release);
+    std::atomic_store(&value_, std::shared_ptr<const CachedResponse>());
+}
+
+std::optional<std::string> EtagRegistry::find(long scheduleId, long ownerId) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = entries_.find(scheduleId);
+    if (it == entries_.end() || it->second.ownerId != ownerId) {
+        return std::nullopt;
+    }
+    return it->second.etag;
+}
+
+unsigned long long EtagRegistry::generation() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return generation_;
+}
+
+void EtagRegistry::remember(unsigned long long seenGeneration, long scheduleId, long ownerId, std::string etag) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (generation_ != seenGeneration) {
+        return;
+    }
+    entries_[scheduleId] = Entry{ownerId, std::move(etag)};
+}
+
+void EtagRegistry::forget(long scheduleId) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    ++generation_;
+    entries_.erase(scheduleId);
+}
+
+void EtagRegistry::clear() {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    ++generation_;
+    entries_.clear();
+}
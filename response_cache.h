@@ -0,0 +1,83 @@
+// response_cache.h — готовые ответы публичных эндпоинтов, общие для всех потоков
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+// Ответ, сериализованный один раз и отдаваемый всем как есть
+struct CachedResponse {
+    int status = 200;
+    std::string body;
+    std::string etag; // только для status 200
+
+    // сжатые варианты body; пустые — не готовились (см. precompress)
+    std::string gzipBody;
+    std::string brotliBody;
+};
+
+// Один раз сжимает body в gzip и br, если оно не меньше minBytes
+void precompress(CachedResponse& response, std::size_t minBytes = 1024);
+
+// Строгий ETag по содержимому ответа: "<FNV-1a 64, hex>" (в кавычках)
+std::string contentEtag(const std::string& body);
+
+// Строгий ETag версии расписания: "s<id>-<FNV-1a 64 от updated_at>"
+std::string scheduleEtag(long scheduleId, const std::string& updatedAt);
+
+// Есть ли etag среди тегов заголовка If-None-Match ("*" подходит к любому)
+bool etagMatches(const std::string& ifNoneMatch, const std::string& etag);
+
+// Одно закэшированное значение. Чтение — атомарная загрузка shared_ptr без
+// блокировок; invalidate() и put() редкие и идут под mutex.
+// Поколение защищает от гонки «прочитали из БД старое, а пока сериализовали —
+// данные поменялись»: put() с устаревшим поколением ничего не сохраняет.
+class ResponseCache {
+public:
+    // nullptr — в кэше пусто, нужно собрать ответ из БД
+    std::shared_ptr<const CachedResponse> get() const;
+
+    // Запомнить до чтения из БД и передать в put()
+    unsigned long long generation() const;
+
+    // false — после generation() был invalidate(), ответ не сохранён
+    bool put(unsigned long long seenGeneration, std::shared_ptr<const CachedResponse> response);
+
+    void invalidate();
+
+private:
+    std::shared_ptr<const CachedResponse> value_;
+    std::atomic<unsigned long long> generation_{0};
+    std::mutex writeMutex_;
+};
+
+// Последние отданные версии расписаний: id -> (владелец, ETag).
+// Позволяет ответить 304 на GET /api/schedule/{id}, не обращаясь к БД.
+// Поколение — как в ResponseCache: remember() после forget() с более
+// старым поколением ничего не запоминает.
+class EtagRegistry {
+public:
+    // ETag, если версия известна и расписание принадлежит ownerId
+    std::optional<std::string> find(long scheduleId, long ownerId) const;
+
+    unsigned long long generation() const;
+    void remember(unsigned long long seenGeneration, long scheduleId, long ownerId, std::string etag);
+
+    void forget(long scheduleId);
+    void clear();
+
+private:
+    struct Entry {
+        long ownerId;
+        std::string etag;
+    };
+
+    mutable std::shared_mutex mutex_;
+    std::unordered_map<long, Entry> entries_;
+    unsigned long long generation_ = 0;
+};
@@ -0,0 +1,47 @@
+// schedule_cost.cpp
+#include "schedule_cost.h"
+#include "instance_index.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+double computeSoftCost(
+    const std::vector<Exam>& exams,
+    const InstanceIndex& index,
+    const std::vector<ExamAssignment>& assignments
+) {
+    double difficultyCost = 0.0;
+    long long spreadCost = 0;
+    int dayCount = index.dayCount();
+
+    // groupId -> дни экзаменов группы
+    std::unordered_map<int, std::vector<int>> daysByGroup;
+
+    for (const ExamAssignment& a : assignments) {
+        if (a.examIndex < 0 || a.examIndex >= (int)exams.size()) continue;
+        int ts = index.timeslotIndex(a.timeslotId);
+        if (ts < 0) continue;
+
+        const Exam& exam = exams[a.examIndex];
+        int day = index.dayOfTimeslot(ts);
+
+        const Subject* s = index.findSubject(exam.subjectId);
+        int difficulty = s ? s->difficulty : 1;
+        difficultyCost += difficultyPenalty(difficulty, day, dayCount);
+
+        daysByGroup[exam.groupId].push_back(day);
+    }
+
+    // пары экзаменов группы: после сортировки штрафуются только пары с разницей < 2 дней
+    for (auto& entry : daysByGroup) {
+        std::vector<int>& days = entry.second;
+        std::sort(days.begin(), days.end());
+        for (size_t i = 0; i < days.size(); ++i) {
+            for (size_t j = i + 1; j < days.size() && days[j] - days[i] < 2; ++j) {
+                spreadCost += spreadPairPenalty(days[j] - days[i]);
+            }
+        }
+    }
+
+    return kSoftDifficultyWeight * difficultyCost + kSoftSpreadWeight * (double)spreadCost;
+}
@@ -0,0 +1,30 @@
+// schedule_cost.h — мягкие критерии качества расписания
+#pragma once
+
+#include <vector>
+#include "model.h"
+
+class InstanceIndex;
+
+// Веса мягких критериев
+constexpr double kSoftDifficultyWeight = 1.0; // сложные предметы — ближе к концу сессии
+constexpr double kSoftSpreadWeight     = 3.0; // экзамены группы — разнесены по дням
+
+// Штраф за пару экзаменов одной группы с разницей dayGap дней:
+// в один день — 2, в соседние дни — 1, дальше — 0
+inline int spreadPairPenalty(int dayGap) {
+    if (dayGap < 0) dayGap = -dayGap;
+    return dayGap >= 2 ? 0 : 2 - dayGap;
+}
+
+// Вклад одного экзамена в критерий "сложные в конце": difficulty * (дней до конца сессии)
+inline double difficultyPenalty(int difficulty, int day, int dayCount) {
+    return (double)difficulty * (double)(dayCount - 1 - day);
+}
+
+// Мягкая стоимость расписания (меньше — лучше). Назначения без известного слота не учитываются.
+double computeSoftCost(
+    const std::vector<Exam>& exams,
+    const InstanceIndex& index,
+    const std::vector<ExamAssignment>& assignments
+);
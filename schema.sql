@@ -112,9 +112,22 @@ CREATE TABLE IF NOT EXISTS exam_schedule (
     -- результат генерации (то, что сейчас бэкенд возвращает фронту)
     result_json JSONB NOT NULL,
 
+    -- необязательное имя и публикация (опубликовано не больше одного)
+    name         TEXT,
+    is_public    BOOLEAN NOT NULL DEFAULT FALSE,
+    published_at TIMESTAMPTZ,
+
     created_at  TIMESTAMPTZ NOT NULL DEFAULT now(),
     updated_at  TIMESTAMPTZ NOT NULL DEFAULT now()
 );
 
-CREATE INDEX IF NOT EXISTS idx_exam_schedule_user_id
-    ON exam_schedule(user_id);
+-- для баз, созданных по прежней схеме без этих столбцов
+ALTER TABLE exam_schedule ADD COLUMN IF NOT EXISTS name TEXT;
+ALTER TABLE exam_schedule ADD COLUMN IF NOT EXISTS is_public BOOLEAN NOT NULL DEFAULT FALSE;
+ALTER TABLE exam_schedule ADD COLUMN IF NOT EXISTS published_at TIMESTAMPTZ;
+
+-- список «мои расписания»: WHERE user_id = ? ORDER BY created_at DESC, id DESC
+-- с постраничным продолжением по (created_at, id); заменяет индекс по одному user_id
+DROP INDEX IF EXISTS idx_exam_schedule_user_id;
+CREATE INDEX IF NOT EXISTS idx_exam_schedule_user_created
+    ON exam_schedule(user_id, created_at DESC, id DESC);
@@ -1,14 +1,22 @@
 // server_https.cpp
 #define CPPHTTPLIB_OPENSSL_SUPPORT
+// gzip на лету для остальных JSON-ответов (br на лету слишком медленный)
+#define CPPHTTPLIB_ZLIB_SUPPORT
 #include "httplib.h"
 #include "json.hpp"
 
 #include <string>
 #include <vector>
+#include <algorithm>
 #include <cstdio>
 #include <optional>
 #include <cstdlib>
 #include <cctype>
+#include <map>
+#include <set>
+#include <limits>
+#include <functional>
+#include <atomic>
 
 #include <pqxx/pqxx>
 
@@ -18,9 +26,17 @@
 
 #include "model.h"
 #include "generator.h"
+#include "multistart.h"
+#include "optimizer.h"
+#include "exact_solver.h"
+#include "reschedule.h"
+#include "job_queue.h"
+#include "response_cache.h"
+#include "compression.h"
 #include "graph.h"
 #include "validator.h"
 #include "api_dto.h"
+#include "instance_index.h"
 #include "logger.h"
 
 using nlohmann::json;
@@ -51,6 +67,9 @@ extern int maxExamsPerDayForGroup;
 
 // --------- хелпер: генерация JSON-ответа по данным ---------
 
+// Отчёт об этапе работы: имя этапа и доля выполненного (0..1)
+using StageCallback = std::function<void(const std::string&, double)>;
+
 static std::string makeJsonResponse(
     const std::vector<Group>& groupsLocal,
     const std::vector<Teacher>& teachersLocal,
@@ -60,49 +79,457 @@ static std::string makeJsonResponse(
     const std::vector<Exam>& examsLocal,
     int maxPerDay,
     const std::string& sessionStartLocal,
-    const std::string& sessionEndLocal
+    const std::string& sessionEndLocal,
+    const MultiStartOptions& run,
+    int optimizeMs,
+    const StageCallback& onStage = nullptr
 ) {
-    logInfo("Запускаем graph-генератор (maxPerDay=" + std::to_string(maxPerDay) + ")");
-
-    std::vector<ExamAssignment> assignments = generateSchedule(
-        examsLocal,
+    auto stage = [&](const std::string& name, double progress) {
+        if (onStage) onStage(name, progress);
+    };
+    std::string algorithm = coloringAlgorithmName(run.base.coloring);
+    logInfo("Запускаем генератор algo=" + algorithm +
+            " (maxPerDay=" + std::to_string(maxPerDay) +
+            ", variants=" + std::to_string(run.variants) + ")");
+
+    // индекс id -> сущность строим один раз на весь запрос
+    InstanceIndex index(
         groupsLocal,
+        teachersLocal,
         subjectsLocal,
-        timeslotsLocal,
         roomsLocal,
-        maxPerDay
+        timeslotsLocal
     );
 
-    ScheduleValidator validator;
-    ValidationResult vr = validator.checkAll(
-        examsLocal,
-        groupsLocal,
-        teachersLocal,
-        roomsLocal,
-        timeslotsLocal,
-        assignments,
-        sessionStartLocal,
-        sessionEndLocal,
-        maxPerDay
-    );
+    std::vector<ExamAssignment> assignments;
+    ValidationResult vr;
+
+    stage("generate", 0.05);
+    if (run.base.coloring == ColoringAlgorithm::Exact) {
+        // точный поиск; если он не дал ответа — обычная генерация через DSATUR
+        ExactSolverResult exact;
+        assignments = generateScheduleExact(examsLocal, index, maxPerDay, run.base, exact);
+
+        ScheduleValidator validator;
+        vr = validator.checkAll(
+            examsLocal,
+            index,
+            assignments,
+            sessionStartLocal,
+            sessionEndLocal,
+            maxPerDay
+        );
+
+        if (exact.status == ExactStatus::Infeasible) {
+            std::string why = exact.infeasibleReason.empty() ? "" : ": " + exact.infeasibleReason;
+            vr.prependNote(
+                "Точный поиск: расписания без конфликтов для этих данных не существует" + why +
+                " (показан жадный вариант).");
+        }
+    } else if (run.variants > 1) {
+        // несколько вариантов параллельно, берём лучший по валидатору и мягкой стоимости
+        ScheduleCandidate best = generateScheduleMultiStart(
+            examsLocal,
+            index,
+            maxPerDay,
+            sessionStartLocal,
+            sessionEndLocal,
+            run
+        );
+        assignments = std::move(best.assignments);
+        vr = std::move(best.validation);
+    } else {
+        assignments = generateSchedule(
+            examsLocal,
+            index,
+            maxPerDay,
+            run.base
+        );
+
+        ScheduleValidator validator;
+        vr = validator.checkAll(
+            examsLocal,
+            index,
+            assignments,
+            sessionStartLocal,
+            sessionEndLocal,
+            maxPerDay
+        );
+    }
 
+    // локальный поиск поверх результата генератора, затем повторная проверка
+    if (optimizeMs > 0) {
+        OptimizerOptions opt;
+        opt.timeLimitMs = optimizeMs;
+        opt.seed = run.base.seed;
+        opt.cancel = run.base.cancel;
+        opt.onProgress = [&](const OptimizerProgress& p) {
+            stage("optimize", 0.5 + 0.4 * std::min(1.0, p.elapsedMs / optimizeMs));
+        };
+        stage("optimize", 0.5);
+        improveSchedule(examsLocal, index, maxPerDay, assignments, opt);
+
+        ScheduleValidator validator;
+        vr = validator.checkAll(
+            examsLocal,
+            index,
+            assignments,
+            sessionStartLocal,
+            sessionEndLocal,
+            maxPerDay
+        );
+    }
+
+    stage("render", 0.9);
     ApiResponse resp;
-    resp.algorithm = "graph";
-    resp.schedule  = buildExamViews(
-        examsLocal,
-        groupsLocal,
-        teachersLocal,
-        subjectsLocal,
-        roomsLocal,
-        timeslotsLocal,
-        assignments
-    );
+    resp.algorithm = algorithm;
+    resp.schedule  = buildExamViews(examsLocal, index, assignments);
     resp.ok     = vr.ok;
-    resp.errors = vr.errors;
+    resp.errors = renderViolations(vr, index);
 
     return buildApiResponseJsonString(resp);
 }
 
+// --------- config от фронта -> данные задачи ---------
+
+struct ScheduleConfig {
+    std::vector<Group>    groups;
+    std::vector<Teacher>  teachers;
+    std::vector<Room>     rooms;
+    std::vector<Subject>  subjects;
+    std::vector<Exam>     exams;
+    std::vector<Timeslot> timeslots;
+    std::string sessionStart;
+    std::string sessionEnd;
+    int maxPerDay;
+};
+
+// Разбор config (groups, teachers, rooms, subjects, exams, timeslots, session);
+// отсутствующие поля — дефолты из data.cpp, слоты без "timeslots" генерируются
+static ScheduleConfig parseScheduleConfig(const json& cfg) {
+    ScheduleConfig c;
+
+    // --- session ---
+    c.sessionStart = sessionStart;
+    c.sessionEnd   = sessionEnd;
+    c.maxPerDay    = maxExamsPerDayForGroup;
+
+    if (cfg.contains("session") && cfg["session"].is_object()) {
+        auto jsess = cfg["session"];
+        if (jsess.contains("start") && jsess["start"].is_string())
+            c.sessionStart = jsess["start"].get<std::string>();
+        if (jsess.contains("end") && jsess["end"].is_string())
+            c.sessionEnd = jsess["end"].get<std::string>();
+        if (jsess.contains("maxExamsPerDayForGroup") &&
+            jsess["maxExamsPerDayForGroup"].is_number_integer())
+            c.maxPerDay = jsess["maxExamsPerDayForGroup"].get<int>();
+    }
+
+    // --- groups ---
+    if (cfg.contains("groups") && cfg["groups"].is_array()) {
+        for (auto& jg : cfg["groups"]) {
+            int id           = jg.value("id", 0);
+            std::string name = jg.value("name", std::string("Группа"));
+            int size         = jg.value("size", 0);
+            c.groups.push_back(Group{id, name, size});
+        }
+    }
+
+    // --- teachers ---
+    if (cfg.contains("teachers") && cfg["teachers"].is_array()) {
+        for (auto& jt : cfg["teachers"]) {
+            int id           = jt.value("id", 0);
+            std::string name = jt.value("name", std::string("Преподаватель"));
+            c.teachers.push_back(Teacher{id, name, ""});
+        }
+    }
+
+    // --- rooms ---
+    if (cfg.contains("rooms") && cfg["rooms"].is_array()) {
+        for (auto& jr : cfg["rooms"]) {
+            int id           = jr.value("id", 0);
+            std::string name = jr.value("name", std::string("Аудитория"));
+            int cap          = jr.value("capacity", 0);
+            c.rooms.push_back(Room{id, name, cap});
+        }
+    }
+
+    // --- subjects ---
+    if (cfg.contains("subjects") && cfg["subjects"].is_array()) {
+        for (auto& jsu : cfg["subjects"]) {
+            int id           = jsu.value("id", 0);
+            std::string name = jsu.value("name", std::string("Предмет"));
+            int diff         = jsu.value("difficulty", 3);
+            c.subjects.push_back(Subject{id, name, diff});
+        }
+    }
+
+    // --- exams ---
+    if (cfg.contains("exams") && cfg["exams"].is_array()) {
+        for (auto& je : cfg["exams"]) {
+            int id        = je.value("id", 0);
+            int groupId   = je.value("groupId", 0);
+            int teacherId = je.value("teacherId", 0);
+            int subjectId = je.value("subjectId", 0);
+            int duration  = je.value("durationMinutes", 120);
+            c.exams.push_back(Exam{id, groupId, teacherId, subjectId, duration});
+        }
+    }
+
+    // --- timeslots ---
+    if (cfg.contains("timeslots") && cfg["timeslots"].is_array()) {
+        for (auto& jt : cfg["timeslots"]) {
+            int id           = jt.value("id", 0);
+            std::string date = jt.value("date", std::string("2025-01-20"));
+            int start        = jt.value("startMinutes", 9 * 60);
+            int end          = jt.value("endMinutes", 11 * 60);
+            c.timeslots.push_back(Timeslot{id, date, start, end});
+        }
+    } else {
+        // автогенерация 4 дней по 2 слота
+        std::string base = c.sessionStart;
+        if (base.size() < 10) base = "2025-01-20";
+
+        int day = 1;
+        try {
+            if (base.size() >= 10) {
+                day = std::stoi(base.substr(8, 2));
+            }
+        } catch (...) {
+            day  = 20;
+            base = "2025-01-20";
+        }
+
+        int nextId = 1;
+        for (int i = 0; i < 4; ++i) {
+            std::string d = base;
+            if (d.size() >= 10) {
+                int dd = day + i;
+                char buf[3];
+                std::snprintf(buf, sizeof(buf), "%02d", dd);
+                d[8] = buf[0];
+                d[9] = buf[1];
+            }
+            c.timeslots.push_back(Timeslot{nextId++, d, 9 * 60, 11 * 60});
+            c.timeslots.push_back(Timeslot{nextId++, d, 12 * 60, 14 * 60});
+        }
+    }
+
+    return c;
+}
+
+// --------- генерация + сохранение в БД ---------
+
+// Ответ POST /api/schedule: генерирует расписание, сохраняет его и добавляет scheduleId.
+// При отмене (run.base.cancel) до сохранения результат не сохраняется — JobCancelled
+static std::string generateAndSaveSchedule(
+    db::ScheduleRepository& scheduleRepo,
+    long userId,
+    const ScheduleConfig& c,
+    const std::string& configDump,
+    const std::optional<std::string>& scheduleName,
+    const MultiStartOptions& run,
+    int optimizeMs,
+    const StageCallback& onStage = nullptr
+) {
+    std::string jsonResp = makeJsonResponse(
+        c.groups,
+        c.teachers,
+        c.rooms,
+        c.subjects,
+        c.timeslots,
+        c.exams,
+        c.maxPerDay,
+        c.sessionStart,
+        c.sessionEnd,
+        run,
+        optimizeMs,
+        onStage
+    );
+
+    if (run.base.cancel && run.base.cancel->load()) {
+        logWarning("Генерация отменена, расписание не сохраняем");
+        throw JobCancelled();
+    }
+    if (onStage) onStage("save", 0.95);
+
+    // --- пробуем сохранить расписание в БД ---
+    long scheduleId = -1;
+    try {
+        scheduleId = scheduleRepo.createSchedule(
+            userId,
+            configDump,
+            jsonResp,
+            scheduleName   // <- передаём, если есть
+        );
+        logInfo("Saved schedule id=" + std::to_string(scheduleId) +
+                " for userId=" + std::to_string(userId));
+    } catch (const std::exception& ex) {
+        logError(std::string("Failed to save schedule: ") + ex.what());
+    } catch (...) {
+        logError("Unknown error while saving schedule");
+    }
+
+    // --- если сохранили, добавим scheduleId в ответ ---
+    if (scheduleId > 0) {
+        try {
+            json respJson = json::parse(jsonResp);
+            respJson["scheduleId"] = scheduleId;
+            if (scheduleName.has_value()) {
+                respJson["scheduleName"] = *scheduleName;
+            }
+            return respJson.dump();
+        } catch (...) {
+            return jsonResp;
+        }
+    }
+    return jsonResp;
+}
+
+// --------- правка сохранённого расписания ---------
+
+// Применяет patch к config:
+//   "upsert":  { "<коллекция>": [ {id, ...}, ... ] } — поля объекта с тем же id заменяются, новый id добавляется;
+//   "remove":  { "<коллекция>": [id, ...] };
+//   "session": { ... } — поля поверх прежней сессии.
+// Коллекции: groups, teachers, rooms, subjects, exams, timeslots.
+// В touchedExamIds попадают id добавленных и изменённых экзаменов.
+static void applyConfigPatch(json& cfg, const json& patch, std::vector<int>& touchedExamIds) {
+    static const char* kCollections[] = {"groups", "teachers", "rooms", "subjects", "exams", "timeslots"};
+
+    const json* remove = (patch.contains("remove") && patch["remove"].is_object()) ? &patch["remove"] : nullptr;
+    const json* upsert = (patch.contains("upsert") && patch["upsert"].is_object()) ? &patch["upsert"] : nullptr;
+
+    for (const char* name : kCollections) {
+        if (remove && remove->contains(name) && (*remove)[name].is_array() &&
+            cfg.contains(name) && cfg[name].is_array()) {
+            std::vector<int> ids;
+            for (auto& jid : (*remove)[name]) {
+                if (jid.is_number_integer()) ids.push_back(jid.get<int>());
+            }
+            json kept = json::array();
+            for (auto& item : cfg[name]) {
+                int id = item.value("id", 0);
+                if (std::find(ids.begin(), ids.end(), id) == ids.end()) kept.push_back(item);
+            }
+            cfg[name] = kept;
+        }
+
+        if (upsert && upsert->contains(name) && (*upsert)[name].is_array()) {
+            if (!cfg.contains(name) || !cfg[name].is_array()) cfg[name] = json::array();
+            for (auto& item : (*upsert)[name]) {
+                if (!item.is_object()) continue;
+                int id = item.value("id", 0);
+
+                bool found = false;
+                for (auto& existing : cfg[name]) {
+                    if (existing.value("id", 0) == id) {
+                        existing.update(item);
+                        found = true;
+                        break;
+                    }
+                }
+                if (!found) cfg[name].push_back(item);
+
+                if (std::string(name) == "exams") touchedExamIds.push_back(id);
+            }
+        }
+    }
+
+    if (patch.contains("session") && patch["session"].is_object()) {
+        if (!cfg.contains("session") || !cfg["session"].is_object()) cfg["session"] = json::object();
+        cfg["session"].update(patch["session"]);
+    }
+}
+
+// "HH:MM" -> минуты от полуночи, -1 если формат не тот
+static int parseClockMinutes(const std::string& hhmm) {
+    if (hhmm.size() != 5 || hhmm[2] != ':') return -1;
+    if (!std::isdigit((unsigned char)hhmm[0]) || !std::isdigit((unsigned char)hhmm[1]) ||
+        !std::isdigit((unsigned char)hhmm[3]) || !std::isdigit((unsigned char)hhmm[4])) return -1;
+    return ((hhmm[0] - '0') * 10 + (hhmm[1] - '0')) * 60 + (hhmm[3] - '0') * 10 + (hhmm[4] - '0');
+}
+
+// seed из строки запроса: только десятичное число в диапазоне unsigned
+static std::optional<unsigned> parseSeed(const std::string& text) {
+    if (text.empty() || text.size() > 10) return std::nullopt;
+    unsigned long long value = 0;
+    for (char ch : text) {
+        if (!std::isdigit((unsigned char)ch)) return std::nullopt;
+        value = value * 10 + (ch - '0');
+    }
+    if (value > std::numeric_limits<unsigned>::max()) return std::nullopt;
+    return (unsigned)value;
+}
+
+// Целое из строки запроса в [lo, hi]; иначе — nullopt (ответ 400)
+static std::optional<int> parseIntParam(const std::string& text, int lo, int hi) {
+    if (text.empty() || text.size() > 9) return std::nullopt;
+    int value = 0;
+    for (char ch : text) {
+        if (!std::isdigit((unsigned char)ch)) return std::nullopt;
+        value = value * 10 + (ch - '0');
+    }
+    if (value < lo || value > hi) return std::nullopt;
+    return value;
+}
+
+// GET /api/schedule без авторизации и считается прямо в потоке httplib:
+// мультистарт на нём ограничен, большие запуски — через POST и очередь задач
+static const int kGetMaxVariants = 4;
+static const int kGetMaxBudgetMs = 2000;
+static const int kGetMaxOptimizeMs = 1000;
+
+// Прежние положения экзаменов из сохранённого результата: слот и аудитория — по timeslotId
+// и roomId, если они есть в новом config. В результатах, сохранённых без id, слот ищется
+// по (date, startTime, endTime), аудитория — по имени
+static std::vector<PreviousPlacement> previousPlacementsFromResult(
+    const json& result,
+    const ScheduleConfig& c
+) {
+    std::map<std::string, int> slotByTime;
+    for (const Timeslot& t : c.timeslots) {
+        std::string key = t.date + "|" + std::to_string(t.startMinutes) + "|" + std::to_string(t.endMinutes);
+        slotByTime.emplace(key, t.id);
+    }
+    std::map<std::string, int> roomByName;
+    for (const Room& r : c.rooms) roomByName.emplace(r.name, r.id);
+    std::set<int> slotIds, roomIds;
+    for (const Timeslot& t : c.timeslots) slotIds.insert(t.id);
+    for (const Room& r : c.rooms) roomIds.insert(r.id);
+
+    std::vector<PreviousPlacement> previous;
+    if (!result.contains("schedule") || !result["schedule"].is_array()) return previous;
+
+    for (auto& view : result["schedule"]) {
+        if (!view.contains("examId") || !view["examId"].is_number_integer()) continue;
+
+        int timeslotId = -1;
+        if (view.contains("timeslotId") && view["timeslotId"].is_number_integer()) {
+            int id = view["timeslotId"].get<int>();
+            if (slotIds.count(id)) timeslotId = id;
+        } else {
+            std::string key = view.value("date", std::string()) + "|" +
+                              std::to_string(parseClockMinutes(view.value("startTime", std::string()))) + "|" +
+                              std::to_string(parseClockMinutes(view.value("endTime", std::string())));
+            auto slotIt = slotByTime.find(key);
+            if (slotIt != slotByTime.end()) timeslotId = slotIt->second;
+        }
+
+        int roomId = -1;
+        if (view.contains("roomId") && view["roomId"].is_number_integer()) {
+            int id = view["roomId"].get<int>();
+            if (roomIds.count(id)) roomId = id;
+        } else {
+            auto roomIt = roomByName.find(view.value("roomName", std::string()));
+            if (roomIt != roomByName.end()) roomId = roomIt->second;
+        }
+
+        previous.push_back(PreviousPlacement{view["examId"].get<int>(), timeslotId, roomId});
+    }
+    return previous;
+}
+
 // --------- JWT helpers ---------
 
 static std::string trim(const std::string& s) {
@@ -171,6 +598,75 @@ static std::optional<JwtPayload> getUserFromRequest(
     return verifyJwt(*token, jwtSecret);
 }
 
+// Целое из переменной окружения или fallback, если её нет или она не число
+static int envIntOr(const char* name, int fallback) {
+    const char* val = std::getenv(name);
+    if (!val) return fallback;
+    try {
+        return std::stoi(val);
+    } catch (...) {
+        logWarning(std::string("Некорректное значение ") + name + "=" + val + ", используем " + std::to_string(fallback));
+        return fallback;
+    }
+}
+
+// Ставит ETag; true — клиент прислал тот же тег в If-None-Match, ответ уже 304
+static bool replyNotModified(const httplib::Request& req, httplib::Response& res, const std::string& etag) {
+    res.set_header("ETag", etag);
+    res.set_header("Cache-Control", "no-cache");
+    if (!etagMatches(req.get_header_value("If-None-Match"), etag)) {
+        return false;
+    }
+    res.status = 304;
+    return true;
+}
+
+// Отдаёт готовый ответ в лучшем из принимаемых клиентом сжатий (с 304 по ETag).
+// Тело не копируется: провайдер пишет прямо из кэша, пока держит shared_ptr
+static void sendCached(
+    const httplib::Request& req,
+    httplib::Response& res,
+    const std::shared_ptr<const CachedResponse>& cached
+) {
+    bool hasVariants = !cached->gzipBody.empty() || !cached->brotliBody.empty();
+    ContentEncoding encoding = negotiateEncoding(
+        req.get_header_value("Accept-Encoding"),
+        !cached->gzipBody.empty(),
+        !cached->brotliBody.empty()
+    );
+
+    const std::string* body = &cached->body;
+    if (encoding == ContentEncoding::Gzip) body = &cached->gzipBody;
+    if (encoding == ContentEncoding::Brotli) body = &cached->brotliBody;
+
+    if (hasVariants) {
+        res.set_header("Vary", "Accept-Encoding");
+    }
+
+    if (cached->status == 200) {
+        // у каждого сжатого представления свой строгий ETag
+        std::string etag = cached->etag;
+        if (encoding != ContentEncoding::Identity && etag.size() >= 2) {
+            etag.insert(etag.size() - 1, std::string("-") + contentEncodingName(encoding));
+        }
+        if (replyNotModified(req, res, etag)) {
+            return;
+        }
+    }
+
+    res.status = cached->status;
+    if (encoding != ContentEncoding::Identity) {
+        res.set_header("Content-Encoding", contentEncodingName(encoding));
+    }
+    res.set_content_provider(
+        body->size(),
+        "application/json; charset=utf-8",
+        [cached, body](size_t offset, size_t length, httplib::DataSink& sink) {
+            return sink.write(body->data() + offset, length);
+        }
+    );
+}
+
 int main() {
     logInfo("=== Запуск HTTPS сервера на 127.0.0.1:8443 ===");
 
@@ -190,6 +686,40 @@ int main() {
 
         logInfo("Успешно инициализирована конфигурация БД");
 
+        // Готовые ответы публичных эндпоинтов: их читают все студенты сразу,
+        // а меняются они только при сохранении/публикации расписания
+        ResponseCache publicScheduleCache; // GET /api/public/schedule
+        ResponseCache publicLatestCache;   // GET /api/public/latest
+        EtagRegistry scheduleEtags;        // GET /api/schedule/{id}
+        auto onScheduleChanged = [&](long scheduleId) {
+            publicScheduleCache.invalidate();
+            publicLatestCache.invalidate();
+            if (scheduleId > 0) {
+                scheduleEtags.forget(scheduleId);
+            } else {
+                scheduleEtags.clear(); // неизвестно, что поменялось
+            }
+        };
+        scheduleRepo.setOnChange(onScheduleChanged);
+        // изменения, сделанные другими экземплярами сервера
+        db::ChangeListener scheduleListener(dbFactory, db::kScheduleChangedChannel,
+            [&](const std::string& payload) {
+                long scheduleId = 0;
+                try {
+                    scheduleId = std::stol(payload);
+                } catch (...) {
+                }
+                onScheduleChanged(scheduleId);
+            }
+        );
+
+        // Очередь фоновой генерации (POST /api/schedule по умолчанию):
+        // тяжёлые расчёты не занимают потоки httplib
+        JobQueue jobQueue(
+            envIntOr("KURSACH_JOB_WORKERS", 2),
+            (std::size_t)std::max(1, envIntOr("KURSACH_JOB_QUEUE", 32))
+        );
+
         httplib::SSLServer svr("server-cert.pem", "server-key.pem");
 
         if (!svr.is_valid()) {
@@ -202,34 +732,35 @@ int main() {
 svr.Get("/api/public/schedule", [&](const httplib::Request& req, httplib::Response& res) {
     res.set_header("Access-Control-Allow-Origin", "*");
     res.set_header("Access-Control-Allow-Methods", "GET, OPTIONS");
-    res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization");
+    res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization, If-None-Match");
+    res.set_header("Access-Control-Expose-Headers", "ETag");
 
     try {
-        auto conn = dbFactory.createConnection();
-        pqxx::work tx{*conn};
-
-        // Просто берём самое последнее расписание
-        auto r = tx.exec(
-            "SELECT result_json "
-            "FROM exam_schedule "
-            "ORDER BY created_at DESC "
-            "LIMIT 1"
-        );
-        tx.commit();
-
-        if (r.empty()) {
-            res.status = 404;
-            res.set_content(
-                R"({"error":"no_schedule"})",
-                "application/json; charset=utf-8"
-            );
-            return;
+        auto cached = publicScheduleCache.get();
+        if (!cached) {
+            unsigned long long generation = publicScheduleCache.generation();
+
+            auto conn = dbFactory.acquire();
+            pqxx::work tx{*conn};
+
+            // Просто берём самое последнее расписание
+            auto r = tx.exec_prepared(db::stmt::kLatestResult);
+            tx.commit();
+
+            auto fresh = std::make_shared<CachedResponse>();
+            if (r.empty()) {
+                fresh->status = 404;
+                fresh->body = R"({"error":"no_schedule"})";
+            } else {
+                fresh->body = r[0][0].c_str();
+                fresh->etag = contentEtag(fresh->body);
+                precompress(*fresh);
+            }
+            publicScheduleCache.put(generation, fresh);
+            cached = fresh;
         }
 
-        std::string jsonResp = r[0][0].c_str();
-
-        res.status = 200;
-        res.set_content(jsonResp, "application/json; charset=utf-8");
+        sendCached(req, res, cached);
     } catch (const std::exception& ex) {
         logError(std::string("Error in GET /api/public/schedule: ") + ex.what());
         res.status = 500;
@@ -244,7 +775,7 @@ svr.Get("/api/public/schedule", [&](const httplib::Request& req, httplib::Respon
 svr.Options("/api/public/schedule", [](const httplib::Request& req, httplib::Response& res) {
     res.set_header("Access-Control-Allow-Origin", "*");
     res.set_header("Access-Control-Allow-Methods", "GET, OPTIONS");
-    res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization");
+    res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization, If-None-Match");
     res.status = 204;
 });
 
@@ -252,70 +783,70 @@ svr.Options("/api/public/schedule", [](const httplib::Request& req, httplib::Res
         svr.Get("/api/public/latest", [&](const httplib::Request& req, httplib::Response& res) {
             res.set_header("Access-Control-Allow-Origin", "*");
             res.set_header("Access-Control-Allow-Methods", "GET, OPTIONS");
-            res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization");
+            res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization, If-None-Match");
+            res.set_header("Access-Control-Expose-Headers", "ETag");
 
             try {
-                auto conn = dbFactory.createConnection();
-                pqxx::work tx{*conn};
-
-                auto r = tx.exec(
-                    "SELECT id, user_id, COALESCE(name, '') AS name, "
-                    "       config_json::text AS config_json, "
-                    "       result_json::text AS result_json, "
-                    "       created_at, updated_at "
-                    "FROM exam_schedule "
-                    "ORDER BY created_at DESC, id DESC "
-                    "LIMIT 1"
-                );
-                tx.commit();
-
-                if (r.empty()) {
-                    res.status = 404;
-                    res.set_content(
-                        R"({"error":"no_schedule"})",
-                        "application/json; charset=utf-8"
-                    );
-                    return;
-                }
-
-                const auto& row = r[0];
-
-                long id           = row["id"].as<long>();
-                std::string name  = row["name"].as<std::string>("");
-                std::string createdAt = row["created_at"].as<std::string>("");
-                std::string updatedAt = row["updated_at"].as<std::string>("");
-                std::string configStr = row["config_json"].as<std::string>("");
-                std::string resultStr = row["result_json"].as<std::string>("");
-
-                json configJson;
-                json resultJson;
-
-                try {
-                    configJson = json::parse(configStr);
-                } catch (...) {
-                    configJson = json::object();
+                auto cached = publicLatestCache.get();
+                if (!cached) {
+                    unsigned long long generation = publicLatestCache.generation();
+                    auto fresh = std::make_shared<CachedResponse>();
+
+                    auto conn = dbFactory.acquire();
+                    pqxx::work tx{*conn};
+
+                    auto r = tx.exec_prepared(db::stmt::kLatestSchedule);
+                    tx.commit();
+
+                    if (r.empty()) {
+                        fresh->status = 404;
+                        fresh->body = R"({"error":"no_schedule"})";
+                    } else {
+                        const auto& row = r[0];
+
+                        long id           = row["id"].as<long>();
+                        std::string name  = row["name"].as<std::string>("");
+                        std::string createdAt = row["created_at"].as<std::string>("");
+                        std::string updatedAt = row["updated_at"].as<std::string>("");
+                        std::string configStr = row["config_json"].as<std::string>("");
+                        std::string resultStr = row["result_json"].as<std::string>("");
+
+                        json configJson;
+                        json resultJson;
+
+                        try {
+                            configJson = json::parse(configStr);
+                        } catch (...) {
+                            configJson = json::object();
+                        }
+
+                        try {
+                            resultJson = json::parse(resultStr);
+                        } catch (...) {
+                            resultJson = json::object();
+                        }
+
+                        json resp = {
+                            {"ok", true},
+                            {"schedule", {
+                                {"id", id},
+                                {"name", name},
+                                {"createdAt", createdAt},
+                                {"updatedAt", updatedAt},
+                                {"config", configJson},
+                                {"result", resultJson}
+                            }}
+                        };
+                        fresh->body = resp.dump();
+                        fresh->etag = contentEtag(fresh->body);
+                        precompress(*fresh);
+                    }
+
+                    publicLatestCache.put(generation, fresh);
+                    cached = fresh;
                 }
 
-                try {
-                    resultJson = json::parse(resultStr);
-                } catch (...) {
-                    resultJson = json::object();
-                }
-
-                json resp = {
-                    {"ok", true},
-                    {"schedule", {
-                        {"id", id},
-                        {"name", name},
-                        {"createdAt", createdAt},
-                        {"updatedAt", updatedAt},
-                        {"config", configJson},
-                        {"result", resultJson}
-                    }}
-                };
-
-                res.status = 200;
-                res.set_content(resp.dump(), "application/json; charset=utf-8");
+                sendCached(req, res, cached);
             } catch (const std::exception& ex) {
                 logError(std::string("Error in GET /api/public/latest: ") + ex.what());
                 res.status = 500;
@@ -330,7 +861,7 @@ svr.Options("/api/public/schedule", [](const httplib::Request& req, httplib::Res
         svr.Options("/api/public/latest", [](const httplib::Request& req, httplib::Response& res) {
             res.set_header("Access-Control-Allow-Origin", "*");
             res.set_header("Access-Control-Allow-Methods", "GET, OPTIONS");
-            res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization");
+            res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization, If-None-Match");
             res.status = 204;
         });
 
@@ -340,8 +871,10 @@ svr.Options("/api/public/schedule", [](const httplib::Request& req, httplib::Res
             res.set_header("Access-Control-Allow-Origin", "*");
             res.set_content(
                 "HTTPS exam schedule server is running.\n"
-                "GET  /api/schedule?maxPerDay=N  (дефолтные данные из data.cpp)\n"
-                "POST /api/schedule              (данные из config, JSON от фронта)\n"
+                "GET  /api/schedule?maxPerDay=N&algo=graph|dsatur|parallel|exact&seed=N&variants=K&budgetMs=T&optimizeMs=T  (дефолтные данные из data.cpp; K<=4, budgetMs<=2000, optimizeMs<=1000)\n"
+                "POST /api/schedule              (данные из config; 202 + jobId, GET /api/schedule/jobs/{jobId}, POST .../cancel)\n"
+                "POST /api/schedule {\"async\":false}  (синхронно: результат сразу в ответе)\n"
+                "POST /api/schedule/{id}/reschedule  (patch к сохранённому config, переставляются только затронутые экзамены)\n"
                 "GET  /api/health/db             (проверка подключения к БД)\n"
                 "AUTH: /api/auth/login, /api/auth/me, /api/admin/ping\n",
                 "text/plain; charset=utf-8"
@@ -402,22 +935,48 @@ svr.Options("/api/public/schedule", [](const httplib::Request& req, httplib::Res
 
         const auto& p = *payloadOpt; // JwtPayload { userId, role, ... }
 
+        // ?limit=N (1..200, по умолчанию 50) & cursor=<nextCursor предыдущей страницы>
+        int limit = 50;
+        std::optional<long> afterId;
         try {
-	    auto items = scheduleRepo.findSchedulesByUser(p.userId);
+            if (req.has_param("limit")) {
+                limit = std::clamp(std::stoi(req.get_param_value("limit")), 1, 200);
+            }
+            if (req.has_param("cursor") && !req.get_param_value("cursor").empty()) {
+                afterId = std::stol(req.get_param_value("cursor"));
+            }
+        } catch (...) {
+            res.status = 400;
+            res.set_content(R"({"error":"bad_request","message":"invalid limit or cursor"})",
+                            "application/json; charset=utf-8");
+            return;
+        }
 
-	    nlohmann::json arr = nlohmann::json::array();
-	    for (const auto &s : items) {
-	        nlohmann::json item;
-	        item["id"]        = s.id;
-	        item["name"]      = s.name;
-	        item["createdAt"] = s.createdAt;
-	        arr.push_back(item);
-	    }
+        try {
+            // на одну строку больше — чтобы понять, есть ли следующая страница
+            auto items = scheduleRepo.listScheduleSummaries(p.userId, afterId, limit + 1);
+            bool hasMore = (int)items.size() > limit;
+            if (hasMore) {
+                items.pop_back();
+            }
 
+            nlohmann::json arr = nlohmann::json::array();
+            for (const auto &s : items) {
+                nlohmann::json item;
+                item["id"]           = s.id;
+                item["name"]         = s.name;
+                item["createdAt"]    = s.createdAt;
+                item["updatedAt"]    = s.updatedAt;
+                item["isPublished"]  = s.isPublished;
+                item["examCount"]    = s.examCount;
+                item["validationOk"] = s.validationOk;
+                arr.push_back(item);
+            }
 
             nlohmann::json resp = {
                 {"ok", true},
-                {"items", arr}
+                {"items", arr},
+                {"nextCursor", hasMore ? nlohmann::json(std::to_string(items.back().id)) : nlohmann::json(nullptr)}
             };
 
             res.status = 200;
@@ -443,7 +1002,8 @@ svr.Options("/api/public/schedule", [](const httplib::Request& req, httplib::Res
 svr.Get(R"(/api/schedule/(\d+))", [&](const httplib::Request& req, httplib::Response& res) {
     res.set_header("Access-Control-Allow-Origin", "*");
     res.set_header("Access-Control-Allow-Methods", "GET, OPTIONS");
-    res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization");
+    res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization, If-None-Match");
+    res.set_header("Access-Control-Expose-Headers", "ETag");
 
     // проверяем JWT
     auto payloadOpt = getUserFromRequest(req, jwtSecret);
@@ -472,7 +1032,16 @@ svr.Get(R"(/api/schedule/(\d+))", [&](const httplib::Request& req, httplib::Resp
         return;
     }
 
+    // версия, которую мы уже отдавали этому владельцу, — 304 без запроса к БД
+    if (req.has_header("If-None-Match")) {
+        auto known = scheduleEtags.find(scheduleId, user.userId);
+        if (known && replyNotModified(req, res, *known)) {
+            return;
+        }
+    }
+
     try {
+        unsigned long long etagGeneration = scheduleEtags.generation();
         auto dbScheduleOpt = scheduleRepo.findScheduleById(user.userId, scheduleId);
         if (!dbScheduleOpt.has_value()) {
             res.status = 404;
@@ -482,6 +1051,12 @@ svr.Get(R"(/api/schedule/(\d+))", [&](const httplib::Request& req, httplib::Resp
 
         const db::DbSchedule& s = *dbScheduleOpt;
 
+        std::string etag = scheduleEtag(s.id, s.updatedAt);
+        scheduleEtags.remember(etagGeneration, s.id, s.userId, etag);
+        if (replyNotModified(req, res, etag)) {
+            return;
+        }
+
         // парсим сохранённые JSON-строки
         json configJson = json::parse(s.configJson);
         json resultJson = json::parse(s.resultJson);
@@ -507,6 +1082,213 @@ svr.Get(R"(/api/schedule/(\d+))", [&](const httplib::Request& req, httplib::Resp
     }
 });
 
+// --- GET /api/schedule/jobs/{id} — статус фоновой генерации ---
+svr.Get(R"(/api/schedule/jobs/([0-9a-f]+))", [&](const httplib::Request& req, httplib::Response& res) {
+    res.set_header("Access-Control-Allow-Origin", "*");
+    res.set_header("Access-Control-Allow-Methods", "GET, OPTIONS");
+    res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization");
+
+    auto payloadOpt = getUserFromRequest(req, jwtSecret);
+    if (!payloadOpt.has_value()) {
+        res.status = 401;
+        res.set_content(R"({"error":"unauthorized"})", "application/json; charset=utf-8");
+        return;
+    }
+
+    auto info = jobQueue.find(req.matches[1].str());
+    if (!info.has_value() || info->ownerId != static_cast<long>(payloadOpt->userId)) {
+        res.status = 404;
+        res.set_content(R"({"error":"not_found"})", "application/json; charset=utf-8");
+        return;
+    }
+
+    json body = {
+        {"jobId", info->id},
+        {"status", jobStateName(info->state)},
+        {"stage", info->stage},
+        {"progress", info->progress}
+    };
+    if (info->state == JobState::Done) {
+        try {
+            body["result"] = json::parse(info->resultJson);
+        } catch (...) {
+            body["result"] = info->resultJson;
+        }
+    }
+    if (info->state == JobState::Failed) {
+        body["error"] = info->error;
+    }
+    res.set_content(body.dump(), "application/json; charset=utf-8");
+});
+
+svr.Options(R"(/api/schedule/jobs/([0-9a-f]+))", [](const httplib::Request& req, httplib::Response& res) {
+    res.set_header("Access-Control-Allow-Origin", "*");
+    res.set_header("Access-Control-Allow-Methods", "GET, OPTIONS");
+    res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization");
+    res.status = 204;
+});
+
+// --- POST /api/schedule/jobs/{id}/cancel — отмена фоновой генерации ---
+svr.Post(R"(/api/schedule/jobs/([0-9a-f]+)/cancel)", [&](const httplib::Request& req, httplib::Response& res) {
+    res.set_header("Access-Control-Allow-Origin", "*");
+    res.set_header("Access-Control-Allow-Methods", "POST, OPTIONS");
+    res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization");
+
+    auto payloadOpt = getUserFromRequest(req, jwtSecret);
+    if (!payloadOpt.has_value()) {
+        res.status = 401;
+        res.set_content(R"({"error":"unauthorized"})", "application/json; charset=utf-8");
+        return;
+    }
+
+    std::string jobId = req.matches[1].str();
+    auto info = jobQueue.find(jobId);
+    if (!info.has_value() || info->ownerId != static_cast<long>(payloadOpt->userId)) {
+        res.status = 404;
+        res.set_content(R"({"error":"not_found"})", "application/json; charset=utf-8");
+        return;
+    }
+
+    if (!jobQueue.cancel(jobId)) {
+        res.status = 409;
+        res.set_content(R"({"error":"already_finished"})", "application/json; charset=utf-8");
+        return;
+    }
+
+    logInfo("Задача " + jobId + " отменена пользователем userId=" + std::to_string(payloadOpt->userId));
+    res.status = 202;
+    res.set_content(R"({"ok":true})", "application/json; charset=utf-8");
+});
+
+svr.Options(R"(/api/schedule/jobs/([0-9a-f]+)/cancel)", [](const httplib::Request& req, httplib::Response& res) {
+    res.set_header("Access-Control-Allow-Origin", "*");
+    res.set_header("Access-Control-Allow-Methods", "POST, OPTIONS");
+    res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization");
+    res.status = 204;
+});
+
+// --- POST /api/schedule/{id}/reschedule — правка config и перестановка только затронутых экзаменов ---
+svr.Post(R"(/api/schedule/(\d+)/reschedule)", [&](const httplib::Request& req, httplib::Response& res) {
+    res.set_header("Access-Control-Allow-Origin", "*");
+    res.set_header("Access-Control-Allow-Methods", "POST, OPTIONS");
+    res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization");
+
+    auto payloadOpt = getUserFromRequest(req, jwtSecret);
+    if (!payloadOpt.has_value()) {
+        res.status = 401;
+        res.set_content(R"({"error":"unauthorized"})", "application/json; charset=utf-8");
+        return;
+    }
+    const auto& user = *payloadOpt;
+
+    long scheduleId = 0;
+    try {
+        scheduleId = std::stol(req.matches[1].str());
+    } catch (...) {
+        res.status = 400;
+        res.set_content(R"({"error":"bad_request","message":"invalid schedule id"})",
+                        "application/json; charset=utf-8");
+        return;
+    }
+
+    try {
+        json j = json::parse(req.body);
+        if (!j.contains("patch") || !j["patch"].is_object()) {
+            res.status = 400;
+            res.set_content(R"({"error":"invalid JSON or patch"})", "application/json; charset=utf-8");
+            return;
+        }
+
+        auto dbScheduleOpt = scheduleRepo.findScheduleById(user.userId, scheduleId);
+        if (!dbScheduleOpt.has_value()) {
+            res.status = 404;
+            res.set_content(R"({"error":"not_found"})", "application/json; charset=utf-8");
+            return;
+        }
+
+        json cfg = json::parse(dbScheduleOpt->configJson);
+        json storedResult = json::parse(dbScheduleOpt->resultJson);
+
+        // автосгенерированные слоты фиксируем в config, чтобы их id не зависели от правки сессии
+        if (!cfg.contains("timeslots") || !cfg["timeslots"].is_array()) {
+            ScheduleConfig before = parseScheduleConfig(cfg);
+            cfg["timeslots"] = json::array();
+            for (const Timeslot& t : before.timeslots) {
+                cfg["timeslots"].push_back({
+                    {"id", t.id}, {"date", t.date},
+                    {"startMinutes", t.startMinutes}, {"endMinutes", t.endMinutes}
+                });
+            }
+        }
+
+        std::vector<int> touchedExamIds;
+        applyConfigPatch(cfg, j["patch"], touchedExamIds);
+
+        ScheduleConfig c = parseScheduleConfig(cfg);
+        if (c.groups.empty() || c.exams.empty()) {
+            res.status = 400;
+            res.set_content(
+                R"({"error":"config must contain non-empty groups and exams"})",
+                "application/json; charset=utf-8"
+            );
+            return;
+        }
+
+        InstanceIndex index(c.groups, c.teachers, c.subjects, c.rooms, c.timeslots);
+        std::vector<PreviousPlacement> previous = previousPlacementsFromResult(storedResult, c);
+        RepairResult repair = repairSchedule(c.exams, index, c.maxPerDay, previous, touchedExamIds);
+
+        ScheduleValidator validator;
+        ValidationResult vr = validator.checkAll(
+            c.exams,
+            index,
+            repair.assignments,
+            c.sessionStart,
+            c.sessionEnd,
+            c.maxPerDay
+        );
+
+        ApiResponse resp;
+        resp.algorithm = storedResult.value("algorithm", std::string("graph"));
+        resp.schedule  = buildExamViews(c.exams, index, repair.assignments);
+        resp.ok        = vr.ok;
+        resp.errors    = renderViolations(vr, index);
+        std::string jsonResp = buildApiResponseJsonString(resp);
+
+        if (!scheduleRepo.updateSchedule(user.userId, scheduleId, cfg.dump(), jsonResp)) {
+            res.status = 404;
+            res.set_content(R"({"error":"not_found"})", "application/json; charset=utf-8");
+            return;
+        }
+
+        logInfo("POST /api/schedule/" + std::to_string(scheduleId) + "/reschedule userId=" +
+                std::to_string(user.userId) +
+                " touched=" + std::to_string(touchedExamIds.size()) +
+                " changed=" + std::to_string(repair.changedExamIds.size()));
+
+        json respJson = json::parse(jsonResp);
+        respJson["scheduleId"] = scheduleId;
+        respJson["reschedule"] = {
+            {"kept", repair.kept},
+            {"placed", repair.placed},
+            {"unplaced", repair.unplaced},
+            {"changedExamIds", repair.changedExamIds}
+        };
+        res.set_content(respJson.dump(), "application/json; charset=utf-8");
+    } catch (const std::exception& ex) {
+        logError(std::string("Error in POST /api/schedule/{id}/reschedule: ") + ex.what());
+        res.status = 400;
+        res.set_content(R"({"error":"invalid JSON or patch"})", "application/json; charset=utf-8");
+    }
+});
+
+svr.Options(R"(/api/schedule/(\d+)/reschedule)", [](const httplib::Request& req, httplib::Response& res) {
+    res.set_header("Access-Control-Allow-Origin", "*");
+    res.set_header("Access-Control-Allow-Methods", "POST, OPTIONS");
+    res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization");
+    res.status = 204;
+});
+
 	svr.Post("/api/auth/register", [&](const httplib::Request& req, httplib::Response& res) {
     res.set_header("Access-Control-Allow-Origin", "*");
     res.set_header("Access-Control-Allow-Methods", "POST, OPTIONS");
@@ -870,9 +1652,9 @@ svr.Options("/api/admin/schedule/publish", [](const httplib::Request& req, httpl
             res.set_header("Content-Type", "application/json; charset=utf-8");
 
             try {
-                auto conn = dbFactory.createConnection();
+                auto conn = dbFactory.acquire();
                 pqxx::work tx{*conn};
-                auto r = tx.exec("SELECT 1");
+                auto r = tx.exec_prepared(db::stmt::kPing);
                 tx.commit();
 
                 if (r.empty()) {
@@ -933,7 +1715,57 @@ svr.Options("/api/auth/logout", [](const httplib::Request& req, httplib::Respons
                 }
             }
 
-            logInfo("GET /api/schedule (data.cpp) maxPerDay=" + std::to_string(maxPerDay));
+            MultiStartOptions run;
+            int optimizeMs = 0;
+            if (req.has_param("algo")) {
+                std::string algo = req.get_param_value("algo");
+                if (!parseColoringAlgorithm(algo, run.base.coloring)) {
+                    res.status = 400;
+                    res.set_content(R"({"error":"unknown algo"})", "application/json; charset=utf-8");
+                    return;
+                }
+            }
+            if (req.has_param("seed")) {
+                std::optional<unsigned> seed = parseSeed(req.get_param_value("seed"));
+                if (!seed.has_value()) {
+                    res.status = 400;
+                    res.set_content(R"({"error":"invalid seed"})", "application/json; charset=utf-8");
+                    return;
+                }
+                run.base.seed = *seed;
+            }
+            if (req.has_param("variants")) {
+                std::optional<int> variants = parseIntParam(req.get_param_value("variants"), 1, kGetMaxVariants);
+                if (!variants.has_value()) {
+                    res.status = 400;
+                    res.set_content(R"({"error":"variants must be an integer in [1, 4]"})", "application/json; charset=utf-8");
+                    return;
+                }
+                run.variants = *variants;
+            }
+            if (req.has_param("budgetMs")) {
+                std::optional<int> budgetMs = parseIntParam(req.get_param_value("budgetMs"), 0, kGetMaxBudgetMs);
+                if (!budgetMs.has_value()) {
+                    res.status = 400;
+                    res.set_content(R"({"error":"budgetMs must be an integer in [0, 2000]"})", "application/json; charset=utf-8");
+                    return;
+                }
+                run.timeBudgetMs = *budgetMs;
+            }
+            if (req.has_param("optimizeMs")) {
+                std::optional<int> ms = parseIntParam(req.get_param_value("optimizeMs"), 0, kGetMaxOptimizeMs);
+                if (!ms.has_value()) {
+                    res.status = 400;
+                    res.set_content(R"({"error":"optimizeMs must be an integer in [0, 1000]"})", "application/json; charset=utf-8");
+                    return;
+                }
+                optimizeMs = *ms;
+            }
+
+            logInfo("GET /api/schedule (data.cpp) maxPerDay=" + std::to_string(maxPerDay) +
+                    " algo=" + coloringAlgorithmName(run.base.coloring) +
+                    " variants=" + std::to_string(run.variants) +
+                    " optimizeMs=" + std::to_string(optimizeMs));
 
             std::string json = makeJsonResponse(
                 groups,
@@ -944,7 +1776,9 @@ svr.Options("/api/auth/logout", [](const httplib::Request& req, httplib::Respons
                 exams,
                 maxPerDay,
                 sessionStart,
-                sessionEnd
+                sessionEnd,
+                run,
+                optimizeMs
             );
 
             res.set_content(json, "application/json; charset=utf-8");
@@ -990,131 +1824,65 @@ if (j.contains("scheduleName") && j["scheduleName"].is_string()) {
         scheduleName = tmp;
     }
 }
-        // --- session ---
-        std::string sessionStartLocal = sessionStart;
-        std::string sessionEndLocal   = sessionEnd;
-        int maxPerDay                 = maxExamsPerDayForGroup;
-
-        if (cfg.contains("session") && cfg["session"].is_object()) {
-            auto jsess = cfg["session"];
-            if (jsess.contains("start") && jsess["start"].is_string())
-                sessionStartLocal = jsess["start"].get<std::string>();
-            if (jsess.contains("end") && jsess["end"].is_string())
-                sessionEndLocal = jsess["end"].get<std::string>();
-            if (jsess.contains("maxExamsPerDayForGroup") &&
-                jsess["maxExamsPerDayForGroup"].is_number_integer())
-                maxPerDay = jsess["maxExamsPerDayForGroup"].get<int>();
-        }
-
-        // --- groups ---
-        std::vector<Group> groupsLocal;
-        if (cfg.contains("groups") && cfg["groups"].is_array()) {
-            for (auto& jg : cfg["groups"]) {
-                int id           = jg.value("id", 0);
-                std::string name = jg.value("name", std::string("Группа"));
-                int size         = jg.value("size", 0);
-                groupsLocal.push_back(Group{id, name, size});
+        // --- алгоритм генерации: "graph" (по умолчанию), "dsatur", "parallel" или "exact" ---
+        MultiStartOptions run;
+        if (j.contains("algo") && j["algo"].is_string()) {
+            std::string algo = j["algo"].get<std::string>();
+            if (!parseColoringAlgorithm(algo, run.base.coloring)) {
+                res.status = 400;
+                res.set_content(
+                    R"({"error":"unknown algo"})",
+                    "application/json; charset=utf-8"
+                );
+                return;
             }
         }
-
-        // --- teachers ---
-        std::vector<Teacher> teachersLocal;
-        if (cfg.contains("teachers") && cfg["teachers"].is_array()) {
-            for (auto& jt : cfg["teachers"]) {
-                int id           = jt.value("id", 0);
-                std::string name = jt.value("name", std::string("Преподаватель"));
-                teachersLocal.push_back(Teacher{id, name, ""});
+        if (j.contains("seed")) {
+            // отрицательный или больший unsigned seed не обрезаем молча
+            if (!j["seed"].is_number_unsigned() ||
+                j["seed"].get<unsigned long long>() > std::numeric_limits<unsigned>::max()) {
+                res.status = 400;
+                res.set_content(
+                    R"({"error":"invalid seed"})",
+                    "application/json; charset=utf-8"
+                );
+                return;
             }
+            run.base.seed = j["seed"].get<unsigned>();
         }
 
-        // --- rooms ---
-        std::vector<Room> roomsLocal;
-        if (cfg.contains("rooms") && cfg["rooms"].is_array()) {
-            for (auto& jr : cfg["rooms"]) {
-                int id           = jr.value("id", 0);
-                std::string name = jr.value("name", std::string("Аудитория"));
-                int cap          = jr.value("capacity", 0);
-                roomsLocal.push_back(Room{id, name, cap});
-            }
+        // --- мультистарт: variants > 1 вариантов параллельно в пределах budgetMs ---
+        if (j.contains("variants") && j["variants"].is_number_integer()) {
+            run.variants = std::max(1, std::min(j["variants"].get<int>(), 64));
         }
-
-        // --- subjects ---
-        std::vector<Subject> subjectsLocal;
-        if (cfg.contains("subjects") && cfg["subjects"].is_array()) {
-            for (auto& jsu : cfg["subjects"]) {
-                int id           = jsu.value("id", 0);
-                std::string name = jsu.value("name", std::string("Предмет"));
-                int diff         = jsu.value("difficulty", 3);
-                subjectsLocal.push_back(Subject{id, name, diff});
-            }
+        if (j.contains("budgetMs") && j["budgetMs"].is_number_integer()) {
+            run.timeBudgetMs = std::max(0, std::min(j["budgetMs"].get<int>(), 60000));
         }
 
-        // --- exams ---
-        std::vector<Exam> examsLocal;
-        if (cfg.contains("exams") && cfg["exams"].is_array()) {
-            for (auto& je : cfg["exams"]) {
-                int id        = je.value("id", 0);
-                int groupId   = je.value("groupId", 0);
-                int teacherId = je.value("teacherId", 0);
-                int subjectId = je.value("subjectId", 0);
-                int duration  = je.value("durationMinutes", 120);
-                examsLocal.push_back(Exam{id, groupId, teacherId, subjectId, duration});
-            }
+        // --- улучшение локальным поиском: optimizeMs > 0 — лимит времени в мс ---
+        int optimizeMs = 0;
+        if (j.contains("optimizeMs") && j["optimizeMs"].is_number_integer()) {
+            optimizeMs = std::max(0, std::min(j["optimizeMs"].get<int>(), 60000));
         }
 
-        // --- timeslots ---
-        std::vector<Timeslot> timeslotsLocal;
-        if (cfg.contains("timeslots") && cfg["timeslots"].is_array()) {
-            for (auto& jt : cfg["timeslots"]) {
-                int id           = jt.value("id", 0);
-                std::string date = jt.value("date", std::string("2025-01-20"));
-                int start        = jt.value("startMinutes", 9 * 60);
-                int end          = jt.value("endMinutes", 11 * 60);
-                timeslotsLocal.push_back(Timeslot{id, date, start, end});
-            }
-        } else {
-            // автогенерация 4 дней по 2 слота
-            std::string base = sessionStartLocal;
-            if (base.size() < 10) base = "2025-01-20";
-
-            int day = 1;
-            try {
-                if (base.size() >= 10) {
-                    day = std::stoi(base.substr(8, 2));
-                }
-            } catch (...) {
-                day  = 20;
-                base = "2025-01-20";
-            }
-
-            int nextId = 1;
-            for (int i = 0; i < 4; ++i) {
-                std::string d = base;
-                if (d.size() >= 10) {
-                    int dd = day + i;
-                    char buf[3];
-                    std::snprintf(buf, sizeof(buf), "%02d", dd);
-                    d[8] = buf[0];
-                    d[9] = buf[1];
-                }
-                timeslotsLocal.push_back(Timeslot{nextId++, d, 9 * 60, 11 * 60});
-                timeslotsLocal.push_back(Timeslot{nextId++, d, 12 * 60, 14 * 60});
-            }
-        }
+        ScheduleConfig c = parseScheduleConfig(cfg);
 
         logInfo(
             "POST /api/schedule "
             "userId=" + std::to_string(authUser.userId) +
-            " groups="   + std::to_string(groupsLocal.size()) +
-            " teachers=" + std::to_string(teachersLocal.size()) +
-            " rooms="    + std::to_string(roomsLocal.size()) +
-            " subjects=" + std::to_string(subjectsLocal.size()) +
-            " exams="    + std::to_string(examsLocal.size()) +
-            " timeslots="+ std::to_string(timeslotsLocal.size()) +
-            " maxPerDay="+ std::to_string(maxPerDay)
+            " groups="   + std::to_string(c.groups.size()) +
+            " teachers=" + std::to_string(c.teachers.size()) +
+            " rooms="    + std::to_string(c.rooms.size()) +
+            " subjects=" + std::to_string(c.subjects.size()) +
+            " exams="    + std::to_string(c.exams.size()) +
+            " timeslots="+ std::to_string(c.timeslots.size()) +
+            " maxPerDay="+ std::to_string(c.maxPerDay) +
+            " algo="     + coloringAlgorithmName(run.base.coloring) +
+            " variants=" + std::to_string(run.variants) +
+            " optimizeMs=" + std::to_string(optimizeMs)
         );
 
-        if (groupsLocal.empty() || examsLocal.empty()) {
+        if (c.groups.empty() || c.exams.empty()) {
             res.status = 400;
             res.set_content(
                 R"({"error":"config must contain non-empty groups and exams"})",
@@ -1123,52 +1891,42 @@ if (j.contains("scheduleName") && j["scheduleName"].is_string()) {
             return;
         }
 
-        // --- вызываем генератор+валидатор ---
-        std::string jsonResp = makeJsonResponse(
-            groupsLocal,
-            teachersLocal,
-            roomsLocal,
-            subjectsLocal,
-            timeslotsLocal,
-            examsLocal,
-            maxPerDay,
-            sessionStartLocal,
-            sessionEndLocal
-        );
+        long userId = static_cast<long>(authUser.userId);
+        std::string configDump = cfg.dump();
+
+        // --- по умолчанию задача в очередь, ответ 202 с id для опроса: иначе тяжёлая
+        //     генерация занимает поток httplib и задерживает /api/public/*.
+        //     "async": false — синхронный ответ (скрипты, небольшие конфиги) ---
+        bool async = !(j.contains("async") && j["async"].is_boolean() && !j["async"].get<bool>());
+        if (async) {
+            auto jobId = jobQueue.submit(userId,
+                [&scheduleRepo, c, run, optimizeMs, configDump, scheduleName, userId](JobContext& ctx) {
+                    MultiStartOptions jobRun = run;
+                    jobRun.base.cancel = ctx.cancelFlag();
+                    return generateAndSaveSchedule(
+                        scheduleRepo, userId, c, configDump, scheduleName, jobRun, optimizeMs,
+                        [&ctx](const std::string& stage, double progress) { ctx.setProgress(stage, progress); }
+                    );
+                });
 
-        // --- пробуем сохранить расписание в БД ---
-        long scheduleId = -1;
-        try {
-            std::string configDump = cfg.dump();
-	    scheduleId = scheduleRepo.createSchedule(
-    		static_cast<long>(authUser.userId),
-    		configDump,
-   	 	jsonResp,
-    	        scheduleName   // <- передаём, если есть
-	    );
-            logInfo("Saved schedule id=" + std::to_string(scheduleId) +
-                    " for userId=" + std::to_string(authUser.userId));
-        } catch (const std::exception& ex) {
-            logError(std::string("Failed to save schedule: ") + ex.what());
-        } catch (...) {
-            logError("Unknown error while saving schedule");
-        }
+            if (!jobId.has_value()) {
+                res.status = 503;
+                res.set_content(R"({"error":"queue_full"})", "application/json; charset=utf-8");
+                return;
+            }
 
-        // --- если сохранили, добавим scheduleId в ответ ---
-	if (scheduleId > 0) {
-    try {
-        json respJson = json::parse(jsonResp);
-        respJson["scheduleId"] = scheduleId;
-        if (scheduleName.has_value()) {
-            respJson["scheduleName"] = *scheduleName;
+            logInfo("POST /api/schedule: задача " + *jobId + " поставлена в очередь");
+            json body = {{"jobId", *jobId}, {"status", "queued"}};
+            res.status = 202;
+            res.set_content(body.dump(), "application/json; charset=utf-8");
+            return;
         }
-        res.set_content(respJson.dump(), "application/json; charset=utf-8");
-    } catch (...) {
+
+        // --- синхронно: генератор+валидатор+сохранение ---
+        std::string jsonResp = generateAndSaveSchedule(
+            scheduleRepo, userId, c, configDump, scheduleName, run, optimizeMs
+        );
         res.set_content(jsonResp, "application/json; charset=utf-8");
-    }
-} else {
-    res.set_content(jsonResp, "application/json; charset=utf-8");
-}
 
 
     } catch (const std::exception& ex) {
@@ -1,40 +1,23 @@
 #include "validator.h"
+#include "instance_index.h"
 #include "logger.h"
-#include <map>
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
 
-std::string findGroupNameById(const std::vector<Group>& groups, int groupId) {
-    for (const Group& g : groups) if (g.id == groupId) return g.name;
-    return "Ошибка";
+static std::string findGroupNameById(const InstanceIndex& index, int groupId) {
+    const Group* g = index.findGroup(groupId);
+    return g ? g->name : "Ошибка";
 }
 
-std::string findTeacherNameById(const std::vector<Teacher>& teacher, int teacherId) {
-    for (const Teacher& t : teacher) if (t.id == teacherId) return t.name;
-    return "Ошибка";
+static std::string findTeacherNameById(const InstanceIndex& index, int teacherId) {
+    const Teacher* t = index.findTeacher(teacherId);
+    return t ? t->name : "Ошибка";
 }
 
-std::string findRoomNameById(const std::vector<Room>& rooms, int roomId) {
-    for (const Room& r : rooms) if (r.id == roomId) return r.name;
-    return "Ошибка";
-}
-
-const Room* findRoomById(const std::vector<Room>& rooms, int roomId) {
-    for (const Room& r : rooms) if (r.id == roomId) return &r;
-    return nullptr;
-}
-
-const Group* findGroupById(const std::vector<Group>& groups, int groupId) {
-    for (const Group& g : groups) if (g.id == groupId) return &g;
-    return nullptr;
-}
-
-const Timeslot* findTimeslotById(const std::vector<Timeslot>& timeslots, int timeslotId) {
-    for (const Timeslot& t : timeslots) if (t.id == timeslotId) return &t;
-    return nullptr;
-}
-
-const Group* findGroupByIdForScheduler(const std::vector<Group>& groups, int groupId) {
-    for (const Group& g : groups) if (g.id == groupId) return &g;
-    return nullptr;
+static std::string findRoomNameById(const InstanceIndex& index, int roomId) {
+    const Room* r = index.findRoom(roomId);
+    return r ? r->name : "Ошибка";
 }
 
 std::string twoDigits(int x) {
@@ -57,354 +40,606 @@ std::string makeDate(const Timeslot& timeslot) {
     return date;
 }
 
-std::string findTimeslotDescription(const std::vector<Timeslot>& timeslots, int timeslotId) {
+static std::string findTimeslotDescription(const InstanceIndex& index, int timeslotId) {
     // вид "2025-01-20 09:00–11:00"
-    for (const Timeslot& t : timeslots) if (t.id == timeslotId) return makeDate(t);
-    return "Ошибка";
+    const Timeslot* t = index.findTimeslot(timeslotId);
+    return t ? makeDate(*t) : "Ошибка";
 }
 
-void ScheduleValidator::checkGroupConflicts(
-    const std::vector<Exam>& exams,
-    const std::vector<Group>& groups,
-    const std::vector<Timeslot>& timeslots,
-    const std::vector<ExamAssignment>& assignments,
-    ValidationResult& result
-) {
-    std::map<std::pair<int, int>, std::vector<int>> table;
-
-    for (const ExamAssignment& a : assignments) {
-        int examIndex = a.examIndex;
-        int timeslotId = a.timeslotId;
+namespace {
+
+// Плотные номера сущностей для счётчиков: индекс из InstanceIndex, а id,
+// которых нет в config, получают номера следом — их накладки тоже попадают в отчёт
+class DenseIds {
+public:
+    explicit DenseIds(int known) : known_(known) {}
+
+    int key(int id, int knownIndex) {
+        if (knownIndex >= 0) return knownIndex;
+        auto it = extra_.find(id);
+        if (it != extra_.end()) return it->second;
+        int k = known_ + (int)extraIds_.size();
+        extra_.emplace(id, k);
+        extraIds_.push_back(id);
+        return k;
+    }
 
-        const Exam& exam = exams[examIndex];
-        int groupId = exam.groupId;
+    int size() const { return known_ + (int)extraIds_.size(); }
+    bool isKnown(int key) const { return key < known_; }
 
-        std::pair<int, int> key(groupId, timeslotId);
-        table[key].push_back(examIndex);
+    // id по плотному номеру; для известных — из вектора сущностей
+    template <typename T>
+    int idOf(int key, const std::vector<T>& items) const {
+        return isKnown(key) ? items[key].id : extraIds_[key - known_];
     }
 
-    for (const std::pair<std::pair<int, int>, std::vector<int>>& p : table) {
-        if (p.second.size() > 1) {
-            result.ok = false;
-
-            int groupId = p.first.first;
-            int timeslotId = p.first.second;
+private:
+    int known_;
+    std::unordered_map<int, int> extra_;
+    std::vector<int> extraIds_;
+};
+
+// Накладка: (сущность, слот или день) в порядке исходных id — как раньше давал std::map
+struct Clash {
+    int ownerId;
+    int slotOrDay; // id слота или плотный номер дня (дни уже идут по возрастанию даты)
+    int key;       // ячейка счётчика
+};
+
+void sortClashes(std::vector<Clash>& clashes) {
+    std::sort(clashes.begin(), clashes.end(), [](const Clash& a, const Clash& b) {
+        if (a.ownerId != b.ownerId) return a.ownerId < b.ownerId;
+        return a.slotOrDay < b.slotOrDay;
+    });
+}
 
-            std::string groupName = findGroupNameById(groups, groupId);
-            std::string timeslotInfo = findTimeslotDescription(timeslots, timeslotId);
-                
-            std::string errorMessage = "Конфликт для группы " + groupName +
-                                       " в " + timeslotInfo +
-                                       ": назначено " + std::to_string(p.second.size()) +
-                                       " экзамен(ов) одновременно.";
+// Слот, занятый сущностью; в найденных пересечениях laterSlot — второй слот пары
+struct SlotUse {
+    int owner;
+    int slot;
+    int laterSlot = -1;
+};
+
+// Пересечения по времени между разными слотами одной сущности. used — пары
+// (сущность, индекс слота) без повторов, слоты только из index. Заметающая прямая
+// по началу слота внутри каждой пары (сущность, день): O(k log k + число пересечений).
+// Результат — по сущностям, внутри — по началу слотов
+std::vector<SlotUse> findSlotOverlaps(std::vector<SlotUse>& used, const InstanceIndex& index) {
+    const std::vector<Timeslot>& timeslots = index.timeslots();
+    std::sort(used.begin(), used.end(), [&](const SlotUse& x, const SlotUse& y) {
+        if (x.owner != y.owner) return x.owner < y.owner;
+        int dx = index.dayOfTimeslot(x.slot), dy = index.dayOfTimeslot(y.slot);
+        if (dx != dy) return dx < dy;
+        if (timeslots[x.slot].startMinutes != timeslots[y.slot].startMinutes) {
+            return timeslots[x.slot].startMinutes < timeslots[y.slot].startMinutes;
+        }
+        return x.slot < y.slot;
+    });
+
+    std::vector<SlotUse> found;
+    std::vector<int> active;
+    for (size_t k = 0; k < used.size(); ++k) {
+        const SlotUse& u = used[k];
+        const Timeslot& t = timeslots[u.slot];
+        if (k == 0 || used[k - 1].owner != u.owner ||
+            index.dayOfTimeslot(used[k - 1].slot) != index.dayOfTimeslot(u.slot)) {
+            active.clear();
+        }
 
-            result.errors.push_back(errorMessage);
-            logError("[GroupConflict] " + errorMessage);
+        int kept = 0;
+        for (int a : active) {
+            if (timeslots[a].endMinutes <= t.startMinutes) continue;
+            active[kept++] = a;
+            if (timeslotsOverlap(timeslots[a], t)) found.push_back({u.owner, a, u.slot});
         }
+        active.resize(kept);
+        active.push_back(u.slot);
     }
+    return found;
 }
 
+} // namespace
+
+const char* violationKindName(ViolationKind kind) {
+    switch (kind) {
+        case ViolationKind::ExamIndexOutOfRange: return "ExamIndexOutOfRange";
+        case ViolationKind::ExamNotAssigned: return "ExamNotAssigned";
+        case ViolationKind::ExamMultiAssigned: return "ExamMultiAssigned";
+        case ViolationKind::GroupConflict: return "GroupConflict";
+        case ViolationKind::TeacherConflict: return "TeacherConflict";
+        case ViolationKind::RoomConflict: return "RoomConflict";
+        case ViolationKind::GroupOverlap: return "GroupOverlap";
+        case ViolationKind::TeacherOverlap: return "TeacherOverlap";
+        case ViolationKind::RoomOverlap: return "RoomOverlap";
+        case ViolationKind::RoomMissing: return "RoomMissing";
+        case ViolationKind::RoomDataError: return "RoomDataError";
+        case ViolationKind::RoomCapacity: return "RoomCapacity";
+        case ViolationKind::SessionBounds: return "SessionBounds";
+        case ViolationKind::DayTimeslotMissing: return "DayTimeslotMissing";
+        case ViolationKind::MaxPerDayExceeded: return "MaxPerDayExceeded";
+        case ViolationKind::Note: return "Note";
+    }
+    return "Unknown";
+}
 
-void ScheduleValidator::checkTeacherConflicts(
-    const std::vector<Exam>& exams,
-    const std::vector<Teacher>& teachers,
-    const std::vector<Timeslot>& timeslots,
-    const std::vector<ExamAssignment>& assignments,
-    ValidationResult& result
-) {
-    std::map<std::pair<int, int>, std::vector<int>> table;
-
-    for (const ExamAssignment& a : assignments) {
-        int examIndex = a.examIndex;
-        int timeslotId = a.timeslotId;
-
-        const Exam& exam = exams[examIndex];
-        int teacherId = exam.teacherId;
+void ValidationResult::prependNote(std::string text) {
+    Violation v{ViolationKind::Note};
+    v.a = notes.size();
+    notes.push_back(std::move(text));
+    violations.insert(violations.begin(), v);
+    ok = false;
+}
 
-        std::pair<int, int> key(teacherId, timeslotId);
-        table[key].push_back(examIndex);
-    }
+std::string renderViolation(const ValidationResult& result, const Violation& v, const InstanceIndex& index) {
+    switch (v.kind) {
+        case ViolationKind::ExamIndexOutOfRange:
+            return "Ошибка данных: examIndex вне диапазона в назначениях.";
+
+        case ViolationKind::ExamNotAssigned:
+            return "Экзамен с id=" + std::to_string(v.a) + " не назначен ни в один слот.";
+
+        case ViolationKind::ExamMultiAssigned:
+            return "Экзамен с id=" + std::to_string(v.a) +
+                   " назначен " + std::to_string(v.count) + " раз(а) в расписании.";
+
+        case ViolationKind::GroupConflict:
+            return "Конфликт для группы " + findGroupNameById(index, v.a) +
+                   " в " + findTimeslotDescription(index, v.slot) +
+                   ": назначено " + std::to_string(v.count) +
+                   " экзамен(ов) одновременно.";
+
+        case ViolationKind::TeacherConflict:
+            return "Конфликт для преподавателя " + findTeacherNameById(index, v.a) +
+                   " в " + findTimeslotDescription(index, v.slot) +
+                   ": назначено " + std::to_string(v.count) +
+                   " экзамен(ов) одновременно.";
+
+        case ViolationKind::RoomConflict:
+            return "Конфликт по аудитории " + findRoomNameById(index, v.a) +
+                   " в " + findTimeslotDescription(index, v.slot) +
+                   ": назначено " + std::to_string(v.count) +
+                   " экзамен(ов) одновременно.";
+
+        case ViolationKind::GroupOverlap:
+            return "Пересечение по времени для группы " + findGroupNameById(index, v.a) +
+                   ": " + findTimeslotDescription(index, v.slot) +
+                   " и " + findTimeslotDescription(index, v.b) + ".";
+
+        case ViolationKind::TeacherOverlap:
+            return "Пересечение по времени для преподавателя " + findTeacherNameById(index, v.a) +
+                   ": " + findTimeslotDescription(index, v.slot) +
+                   " и " + findTimeslotDescription(index, v.b) + ".";
+
+        case ViolationKind::RoomOverlap:
+            return "Пересечение по времени в аудитории " + findRoomNameById(index, v.a) +
+                   ": " + findTimeslotDescription(index, v.slot) +
+                   " и " + findTimeslotDescription(index, v.b) + ".";
+
+        case ViolationKind::RoomMissing:
+            return "Экзамен с examIndex=" + std::to_string(v.a) +
+                   " не имеет назначенной аудитории (roomId < 0).";
+
+        case ViolationKind::RoomDataError:
+            return "Ошибка данных: не найдена аудитория или группа по id (roomId=" +
+                   std::to_string(v.a) + ", groupId=" + std::to_string(v.b) + ").";
+
+        case ViolationKind::RoomCapacity: {
+            const Room* room = index.findRoom(v.a);
+            const Group* group = index.findGroup(v.b);
+            if (!room || !group) break;
+            return "Аудитория " + room->name + " слишком мала для группы " + group->name +
+                   ": capacity=" + std::to_string(room->capacity) +
+                   ", peopleCount=" + std::to_string(group->peopleCount) + ".";
+        }
 
-    for (const std::pair<std::pair<int, int>, std::vector<int>>& p : table) {
-        if (p.second.size() > 1) {
-            result.ok = false;
+        case ViolationKind::SessionBounds:
+            return "Слот " + makeDate(index.timeslots()[v.slot]) +
+                   " выходит за пределы периода сессии " +
+                   result.sessionStartDate + " - " + result.sessionEndDate + ".";
 
-            int teacherId = p.first.first;
-            int timeslotId = p.first.second;
+        case ViolationKind::DayTimeslotMissing:
+            return "Ошибка данных: не найден timeslot по id при проверке количества экзаменов в день.";
 
-            std::string teacherName = findTeacherNameById(teachers, teacherId);
-            std::string timeslotInfo = findTimeslotDescription(timeslots, timeslotId);
-                
-            std::string errorMessage = "Конфликт для преподавателя " + teacherName +
-                                       " в " + timeslotInfo +
-                                       ": назначено " + std::to_string(p.second.size()) +
-                                       " экзамен(ов) одновременно.";
+        case ViolationKind::MaxPerDayExceeded:
+            return "У группы " + findGroupNameById(index, v.a) +
+                   " в день " + index.dayDate(v.slot) +
+                   " назначено " + std::to_string(v.count) +
+                   " экзамен(ов), что превышает допустимый максимум " +
+                   std::to_string(result.maxExamsPerDayForGroup) + ".";
 
-            result.errors.push_back(errorMessage);
-            logError("[TeacherConflict] " + errorMessage);
-        }
+        case ViolationKind::Note:
+            return result.notes[v.a];
     }
+    return std::string("Ошибка проверки: ") + violationKindName(v.kind);
 }
 
+std::vector<std::string> renderViolations(const ValidationResult& result, const InstanceIndex& index) {
+    std::vector<std::string> out;
+    out.reserve(result.violations.size());
+    for (const Violation& v : result.violations) {
+        out.push_back(renderViolation(result, v, index));
+    }
+    return out;
+}
 
-void ScheduleValidator::checkRoomConflicts(
+ValidationResult ScheduleValidator::checkAll(
     const std::vector<Exam>& exams,
     const std::vector<Group>& groups,
+    const std::vector<Teacher>& teachers,
     const std::vector<Room>& rooms,
     const std::vector<Timeslot>& timeslots,
     const std::vector<ExamAssignment>& assignments,
-    ValidationResult& result
+    const std::string& sessionStartDate,
+    const std::string& sessionEndDate,
+    int maxExamsPerDayForGroup
 ) {
-    // Конфликт по две пары в одной аудитории одновременно
-    // (roomId, timeslotId) -> список examIndex
-    // (roomId, timeslotId) -> список examIndex
-    std::map<std::pair<int, int>, std::vector<int>> table;
-
-    for (const ExamAssignment& a : assignments) {
-        int examIndex = a.examIndex;
-        int timeslotId = a.timeslotId;
-        int roomId = a.roomId;
+    static const std::vector<Subject> noSubjects;
+    InstanceIndex index(groups, teachers, noSubjects, rooms, timeslots);
+    return checkAll(exams, index, assignments,
+                    sessionStartDate, sessionEndDate, maxExamsPerDayForGroup);
+}
 
-        if (roomId < 0) continue; // не учитываем "нет аудитории" в конфликте занятности
+ValidationResult ScheduleValidator::checkAll(
+    const std::vector<Exam>& exams,
+    const InstanceIndex& index,
+    const std::vector<ExamAssignment>& assignments,
+    const std::string& sessionStartDate,
+    const std::string& sessionEndDate,
+    int maxExamsPerDayForGroup
+) {
+    ValidationResult result;
+    result.ok = true;
+    result.sessionStartDate = sessionStartDate;
+    result.sessionEndDate = sessionEndDate;
+    result.maxExamsPerDayForGroup = maxExamsPerDayForGroup;
+
+    LOG_INFO("=== Запуск проверки расписания ===");
+    LOG_INFO("Экзаменов: " + std::to_string(exams.size()) +
+             ", назначений: " + std::to_string(assignments.size()) +
+             ", групп: " + std::to_string(index.groups().size()) +
+             ", преподавателей: " + std::to_string(index.teachers().size()) +
+             ", аудиторий: " + std::to_string(index.rooms().size()) +
+             ", слотов: " + std::to_string(index.timeslots().size()));
+
+    const std::vector<Group>& groups = index.groups();
+    const std::vector<Teacher>& teachers = index.teachers();
+    const std::vector<Room>& rooms = index.rooms();
+    const std::vector<Timeslot>& timeslots = index.timeslots();
+    const int n = exams.size();
+    const int m = assignments.size();
+    const int maxPerDay = maxExamsPerDayForGroup;
+
+    // 1) плотные номера: группа и преподаватель — на экзамен, слот и аудитория — на назначение
+    DenseIds groupIds(groups.size()), teacherIds(teachers.size());
+    DenseIds slotIds(timeslots.size()), roomIds(rooms.size());
+
+    std::vector<int> examGroup(n), examTeacher(n);
+    for (int i = 0; i < n; ++i) {
+        examGroup[i] = groupIds.key(exams[i].groupId, index.groupIndex(exams[i].groupId));
+        examTeacher[i] = teacherIds.key(exams[i].teacherId, index.teacherIndex(exams[i].teacherId));
+    }
 
-        std::pair<int, int> key(roomId, timeslotId);
-        table[key].push_back(examIndex);
+    std::vector<int> slotKey(m), roomKey(m);
+    for (int k = 0; k < m; ++k) {
+        const ExamAssignment& a = assignments[k];
+        slotKey[k] = slotIds.key(a.timeslotId, index.timeslotIndex(a.timeslotId));
+        roomKey[k] = a.roomId < 0 ? -1 : roomIds.key(a.roomId, index.roomIndex(a.roomId));
     }
 
-    for (const auto& p : table) {
-        const std::pair<int,int>& key = p.first;
-        const std::vector<int>& examIndexes = p.second;
+    // 2) один проход по назначениям с плоскими счётчиками (группа, слот),
+    //    (преподаватель, слот), (аудитория, слот), (группа, день).
+    //    Ячейка попадает в список накладок в момент, когда впервые превышает лимит
+    const int slotCount = slotIds.size();
+    const int dayCount = index.dayCount();
+    std::vector<int> examCount(n, 0);
+    std::vector<int> groupSlot((size_t)groupIds.size() * slotCount, 0);
+    std::vector<int> teacherSlot((size_t)teacherIds.size() * slotCount, 0);
+    std::vector<int> roomSlot((size_t)roomIds.size() * slotCount, 0);
+    std::vector<int> groupDay((size_t)groupIds.size() * dayCount, 0);
+
+    std::vector<Clash> groupClashes, teacherClashes, roomClashes, dayOverloads;
+    // занятые (сущность, слот) — для пересечений разных слотов по времени
+    const bool trackOverlaps = index.hasTimeslotOverlaps();
+    std::vector<SlotUse> groupUsed, teacherUsed, roomUsed;
+    int badExamIndexes = 0;
+    // нарушения по отдельным назначениям — в том же порядке, что и раньше
+    std::vector<Violation> roomErrors;
+    std::vector<Violation> dayDataErrors;
+
+    for (int k = 0; k < m; ++k) {
+        const ExamAssignment& a = assignments[k];
+        int e = a.examIndex;
+        bool examOk = e >= 0 && e < n;
+        int s = slotKey[k];
+
+        if (examOk) {
+            examCount[e]++;
+
+            int g = examGroup[e];
+            size_t gs = (size_t)g * slotCount + s;
+            int gc = ++groupSlot[gs];
+            if (gc == 2) {
+                groupClashes.push_back({groupIds.idOf(g, groups), a.timeslotId, (int)gs});
+            } else if (gc == 1 && trackOverlaps && slotIds.isKnown(s)) {
+                groupUsed.push_back({g, s});
+            }
+
+            int t = examTeacher[e];
+            size_t ts = (size_t)t * slotCount + s;
+            int tc = ++teacherSlot[ts];
+            if (tc == 2) {
+                teacherClashes.push_back({teacherIds.idOf(t, teachers), a.timeslotId, (int)ts});
+            } else if (tc == 1 && trackOverlaps && slotIds.isKnown(s)) {
+                teacherUsed.push_back({t, s});
+            }
+        } else {
+            ++badExamIndexes;
+        }
 
-        if (examIndexes.size() > 1) {
-            result.ok = false;
+        int r = roomKey[k];
+        if (r >= 0) {
+            size_t rs = (size_t)r * slotCount + s;
+            int rc = ++roomSlot[rs];
+            if (rc == 2) {
+                roomClashes.push_back({a.roomId, a.timeslotId, (int)rs});
+            } else if (rc == 1 && trackOverlaps && slotIds.isKnown(s)) {
+                roomUsed.push_back({r, s});
+            }
+        }
 
-            int roomId = key.first;
-            int timeslotId = key.second;
+        // вместимость
+        if (a.roomId < 0) {
+            Violation v{ViolationKind::RoomMissing};
+            v.a = e;
+            roomErrors.push_back(v);
+        } else if (examOk) {
+            bool roomKnown = roomIds.isKnown(r);
+            bool groupKnown = groupIds.isKnown(examGroup[e]);
+
+            if (!roomKnown || !groupKnown) {
+                Violation v{ViolationKind::RoomDataError};
+                v.a = a.roomId;
+                v.b = exams[e].groupId;
+                roomErrors.push_back(v);
+            } else if (groups[examGroup[e]].peopleCount > rooms[r].capacity) {
+                Violation v{ViolationKind::RoomCapacity};
+                v.a = a.roomId;
+                v.b = exams[e].groupId;
+                roomErrors.push_back(v);
+            }
+        }
 
-            std::string roomName = findRoomNameById(rooms, roomId);
-            std::string timeslotInfo = findTimeslotDescription(timeslots, timeslotId);
+        // экзамены группы в день
+        if (!examOk) {
+            dayDataErrors.push_back(Violation{ViolationKind::ExamIndexOutOfRange});
+        } else if (!slotIds.isKnown(s)) {
+            dayDataErrors.push_back(Violation{ViolationKind::DayTimeslotMissing});
+        } else {
+            int g = examGroup[e];
+            int d = index.dayOfTimeslot(s);
+            size_t gd = (size_t)g * dayCount + d;
+            int c = ++groupDay[gd];
+            if (c > maxPerDay && (c == 1 || c - 1 <= maxPerDay)) {
+                dayOverloads.push_back({groupIds.idOf(g, groups), d, (int)gd});
+            }
+        }
+    }
 
-            std::string errorMessage =
-                "Конфликт по аудитории " + roomName +
-                " в " + timeslotInfo +
-                ": назначено " + std::to_string(examIndexes.size()) +
-                " экзамен(ов) одновременно.";
+    // 3) нарушения — в прежнем порядке проверок
+    std::vector<Violation>& out = result.violations;
 
-            result.errors.push_back(errorMessage);
-            logError("[RoomConflict] " + errorMessage);
+    for (int i = 0; i < badExamIndexes; ++i) {
+        out.push_back(Violation{ViolationKind::ExamIndexOutOfRange});
+    }
+    for (int i = 0; i < n; ++i) {
+        if (examCount[i] == 0) {
+            Violation v{ViolationKind::ExamNotAssigned};
+            v.a = exams[i].id;
+            out.push_back(v);
+        } else if (examCount[i] > 1) {
+            Violation v{ViolationKind::ExamMultiAssigned};
+            v.a = exams[i].id;
+            v.count = examCount[i];
+            out.push_back(v);
         }
     }
 
-    // Проверка вместимости
-    for (const ExamAssignment& a : assignments) {
-        int examIndex = a.examIndex;
-        int roomId = a.roomId;
-
-        if (roomId < 0) {
-            result.ok = false;
-            std::string msg = "Экзамен с examIndex=" + std::to_string(examIndex) +
-                            " не имеет назначенной аудитории (roomId < 0).";
-            result.errors.push_back(msg);
-            logError("[RoomMissing] " + msg);
-            continue;
+    auto emitClashes = [&](std::vector<Clash>& clashes, ViolationKind kind, const std::vector<int>& cells) {
+        sortClashes(clashes);
+        for (const Clash& c : clashes) {
+            Violation v{kind};
+            v.a = c.ownerId;
+            v.slot = c.slotOrDay;
+            v.count = cells[c.key];
+            out.push_back(v);
         }
+    };
+
+    emitClashes(groupClashes, ViolationKind::GroupConflict, groupSlot);
+    emitClashes(teacherClashes, ViolationKind::TeacherConflict, teacherSlot);
+    emitClashes(roomClashes, ViolationKind::RoomConflict, roomSlot);
+
+    if (trackOverlaps) {
+        auto emitOverlaps = [&](std::vector<SlotUse>& used, ViolationKind kind, auto ownerIdOf) {
+            std::vector<Violation> found;
+            for (const SlotUse& o : findSlotOverlaps(used, index)) {
+                Violation v{kind};
+                v.a = ownerIdOf(o.owner);
+                v.slot = timeslots[o.slot].id;
+                v.b = timeslots[o.laterSlot].id;
+                found.push_back(v);
+            }
+            std::stable_sort(found.begin(), found.end(),
+                [](const Violation& x, const Violation& y) { return x.a < y.a; });
+            out.insert(out.end(), found.begin(), found.end());
+        };
+        emitOverlaps(groupUsed, ViolationKind::GroupOverlap,
+                     [&](int key) { return groupIds.idOf(key, groups); });
+        emitOverlaps(teacherUsed, ViolationKind::TeacherOverlap,
+                     [&](int key) { return teacherIds.idOf(key, teachers); });
+        emitOverlaps(roomUsed, ViolationKind::RoomOverlap,
+                     [&](int key) { return roomIds.idOf(key, rooms); });
+    }
+    out.insert(out.end(), roomErrors.begin(), roomErrors.end());
 
-        const Exam& exam = exams[examIndex];
-        int groupId = exam.groupId;
-
-        const Room* room = findRoomById(rooms, roomId);
-        const Group* group = findGroupById(groups, groupId);
-
-        if (!room || !group) {
-            result.ok = false;
-            std::string msg = "Ошибка данных: не найдена аудитория или группа по id (roomId=" +
-                            std::to_string(roomId) + ", groupId=" + std::to_string(groupId) + ").";
-            result.errors.push_back(msg);
-            logError("[RoomDataError] " + msg);
-            continue;
+    // Предполагаем формат даты YYYY-MM-DD, тогда сравнение строк работает
+    for (int i = 0; i < (int)timeslots.size(); ++i) {
+        if (timeslots[i].date < sessionStartDate || timeslots[i].date > sessionEndDate) {
+            Violation v{ViolationKind::SessionBounds};
+            v.slot = i;
+            out.push_back(v);
         }
+    }
 
-        if (group->peopleCount > room->capacity) {
-            result.ok = false;
+    out.insert(out.end(), dayDataErrors.begin(), dayDataErrors.end());
+    emitClashes(dayOverloads, ViolationKind::MaxPerDayExceeded, groupDay);
 
-            std::string roomName = room->name;
-            std::string errorMessage =
-                "Аудитория " + roomName + " слишком мала для группы " + group->name +
-                ": capacity=" + std::to_string(room->capacity) +
-                ", peopleCount=" + std::to_string(group->peopleCount) + ".";
+    result.ok = out.empty();
 
-            result.errors.push_back(errorMessage);
-            logError("[RoomCapacity] " + errorMessage);
+    if (result.ok) {
+        LOG_INFO("Проверка расписания завершена: ошибок не обнаружено.");
+    } else {
+        // по числу нарушений каждого вида; тексты собираются только для ответа
+        int byKind[(int)ViolationKind::Note + 1] = {};
+        for (const Violation& v : out) byKind[(int)v.kind]++;
+
+        std::string summary;
+        for (int k = 0; k <= (int)ViolationKind::Note; ++k) {
+            if (!byKind[k]) continue;
+            summary += summary.empty() ? " (" : ", ";
+            summary += std::string(violationKindName((ViolationKind)k)) + "=" + std::to_string(byKind[k]);
         }
-}
+        LOG_WARN("Проверка расписания завершена: обнаружено ошибок = " +
+                 std::to_string(out.size()) + summary + ")");
+    }
 
+    return result;
 }
 
-void ScheduleValidator::checkSessionBounds(
-    const std::vector<Timeslot>& timeslots,
+// ==================== IncrementalValidator ====================
+
+IncrementalValidator::IncrementalValidator(
+    const std::vector<Exam>& exams,
+    const InstanceIndex& index,
+    const std::vector<ExamAssignment>& assignments,
     const std::string& sessionStartDate,
     const std::string& sessionEndDate,
-    ValidationResult& result
-) {
-    // Предполагаем формат даты YYYY-MM-DD, тогда сравнение строк работает
-    for (const Timeslot& t : timeslots) {
-        if (t.date < sessionStartDate || t.date > sessionEndDate) {
-            result.ok = false;
-
-            std::string slotInfo = makeDate(t);
-            std::string errorMessage =
-                "Слот " + slotInfo +
-                " выходит за пределы периода сессии " +
-                sessionStartDate + " - " + sessionEndDate + ".";
-
-            result.errors.push_back(errorMessage);
-            logError("[SessionBounds] " + errorMessage);
-        }
+    int maxExamsPerDayForGroup
+)
+    : exams_(exams),
+      index_(index),
+      sessionStart_(sessionStartDate),
+      sessionEnd_(sessionEndDate),
+      maxPerDay_(maxExamsPerDayForGroup),
+      slotCount_(index.timeslots().size()),
+      dayCount_(index.dayCount()) {
+    const int n = exams.size();
+    if ((int)assignments.size() != n) {
+        throw std::invalid_argument("IncrementalValidator: expected one assignment per exam");
     }
-}
 
-void ScheduleValidator::checkAllExamsAssigned(
-    const std::vector<Exam>& exams,
-    const std::vector<ExamAssignment>& assignments,
-    ValidationResult& result
-) {
-    if (exams.empty()) return;
+    DenseIds groupIds(index.groups().size()), teacherIds(index.teachers().size());
+    group_.resize(n);
+    teacher_.resize(n);
+    knownGroup_.resize(n);
+    for (int i = 0; i < n; ++i) {
+        group_[i] = groupIds.key(exams[i].groupId, index.groupIndex(exams[i].groupId));
+        teacher_[i] = teacherIds.key(exams[i].teacherId, index.teacherIndex(exams[i].teacherId));
+        knownGroup_[i] = groupIds.isKnown(group_[i]);
+    }
 
-    // Сколько раз каждый экзамен встретился в назначениях
-    std::vector<int> counts(exams.size(), 0);
+    groupSlot_.assign((size_t)groupIds.size() * slotCount_, 0);
+    teacherSlot_.assign((size_t)teacherIds.size() * slotCount_, 0);
+    roomSlot_.assign(index.rooms().size() * (size_t)slotCount_, 0);
+    groupDay_.assign((size_t)groupIds.size() * dayCount_, 0);
 
+    assignments_.assign(n, ExamAssignment{-1, -1, -1});
+    slot_.assign(n, -1);
+    room_.assign(n, -1);
+    std::vector<char> seen(n, 0);
     for (const ExamAssignment& a : assignments) {
-        int examIndex = a.examIndex;
-
-        if (examIndex < 0 || examIndex >= (int)exams.size()) {
-            result.ok = false;
-            result.errors.push_back("Ошибка данных: examIndex вне диапазона в назначениях.");
-            continue;
+        checkMove(a);
+        if (seen[a.examIndex]) {
+            throw std::invalid_argument("IncrementalValidator: exam assigned twice");
         }
-
-        counts[examIndex]++;
+        seen[a.examIndex] = 1;
+        assignments_[a.examIndex] = a;
+        slot_[a.examIndex] = index.timeslotIndex(a.timeslotId);
+        room_[a.examIndex] = a.roomId < 0 ? -1 : index.roomIndex(a.roomId);
+        place(a.examIndex, +1);
     }
 
-    for (int i = 0; i < (int)exams.size(); ++i) {
-        const Exam& exam = exams[i];
-
-        if (counts[i] == 0) {
-            result.ok = false;
-
-            std::string errorMessage =
-                "Экзамен с id=" + std::to_string(exam.id) +
-                " не назначен ни в один слот.";
-
-            result.errors.push_back(errorMessage);
-            logError("[ExamNotAssigned] " + errorMessage);
-        }
-        else if (counts[i] > 1) {
-            result.ok = false;
-
-            std::string errorMessage =
-                "Экзамен с id=" + std::to_string(exam.id) +
-                " назначен " + std::to_string(counts[i]) +
-                " раз(а) в расписании.";
-
-            result.errors.push_back(errorMessage);
-            logError("[ExamMultiAssigned] " + errorMessage);
-        }
+    // слоты вне сессии от назначений не зависят
+    for (const Timeslot& t : index.timeslots()) {
+        if (t.date < sessionStart_ || t.date > sessionEnd_) ++violations_;
     }
 }
 
-void ScheduleValidator::checkMaxExamsPerDayForGroup(
-    const std::vector<Exam>& exams,
-    const std::vector<Group>& groups,
-    const std::vector<Timeslot>& timeslots,
-    const std::vector<ExamAssignment>& assignments,
-    int maxPerDay,
-    ValidationResult& result
-) {
-    // (groupId, date) -> количество экзаменов в этот день
-    std::map<std::pair<int, std::string>, int> table;
-
-    for (const ExamAssignment& a : assignments) {
-        int examIndex = a.examIndex;
-        int timeslotId = a.timeslotId;
-
-        if (examIndex < 0 || examIndex >= (int)exams.size()) {
-            result.ok = false;
-            result.errors.push_back("Ошибка данных: examIndex вне диапазона в назначениях.");
-            continue;
-        }
-
-        const Exam& exam = exams[examIndex];
-        int groupId = exam.groupId;
+void IncrementalValidator::checkMove(const ExamAssignment& move) const {
+    if (move.examIndex < 0 || move.examIndex >= (int)exams_.size()) {
+        throw std::invalid_argument("IncrementalValidator: examIndex out of range");
+    }
+    if (index_.timeslotIndex(move.timeslotId) < 0) {
+        throw std::invalid_argument("IncrementalValidator: unknown timeslot id " + std::to_string(move.timeslotId));
+    }
+    if (move.roomId >= 0 && index_.roomIndex(move.roomId) < 0) {
+        throw std::invalid_argument("IncrementalValidator: unknown room id " + std::to_string(move.roomId));
+    }
+}
 
-        const Timeslot* ts = findTimeslotById(timeslots, timeslotId);
-        if (!ts) {
-            result.ok = false;
-            result.errors.push_back("Ошибка данных: не найден timeslot по id при проверке количества экзаменов в день.");
-            continue;
+void IncrementalValidator::place(int exam, int sign) {
+    int s = slot_[exam];
+    int r = room_[exam];
+
+    // ячейка с накладкой — та, где два и больше экзамена. Когда сущность занимает
+    // слот впервые (или освобождает), меняется и число пересечений с её занятыми
+    // слотами, которые перекрываются с ним по времени
+    const std::vector<int>& overlapping = index_.overlappingTimeslots(s);
+    auto bump = [&](std::vector<int>& cells, size_t row) {
+        int before = cells[row + s];
+        int after = before + sign;
+        cells[row + s] = after;
+        violations_ += (after >= 2) - (before >= 2);
+        if ((before == 0) != (after == 0)) {
+            for (int t : overlapping) {
+                if (cells[row + t] > 0) violations_ += sign;
+            }
         }
+    };
 
-        std::pair<int, std::string> key(groupId, ts->date);
-        table[key]++;
+    bump(groupSlot_, (size_t)group_[exam] * slotCount_);
+    bump(teacherSlot_, (size_t)teacher_[exam] * slotCount_);
+    if (r >= 0) {
+        bump(roomSlot_, (size_t)r * slotCount_);
     }
 
-    // Теперь проверяем, где превышен лимит
-    for (const std::pair<std::pair<int, std::string>, int>& p : table) {
-        int groupId = p.first.first;
-        const std::string& date = p.first.second;
-        int count = p.second;
-
-        if (count > maxPerDay) {
-            result.ok = false;
-
-            std::string groupName = findGroupNameById(groups, groupId);
-
-            std::string errorMessage =
-                "У группы " + groupName +
-                " в день " + date +
-                " назначено " + std::to_string(count) +
-                " экзамен(ов), что превышает допустимый максимум " +
-                std::to_string(maxPerDay) + ".";
+    size_t gd = (size_t)group_[exam] * dayCount_ + index_.dayOfTimeslot(s);
+    int before = groupDay_[gd];
+    int after = before + sign;
+    groupDay_[gd] = after;
+    violations_ += (after > maxPerDay_) - (before > maxPerDay_);
 
-            result.errors.push_back(errorMessage);
-        }
-    }
+    // аудитория: нет её, неизвестна группа или мала вместимость — одна ошибка на назначение
+    bool roomProblem = r < 0 || !knownGroup_[exam] ||
+                       index_.groups()[group_[exam]].peopleCount > index_.rooms()[r].capacity;
+    if (roomProblem) violations_ += sign;
 }
 
-ValidationResult ScheduleValidator::checkAll(
-    const std::vector<Exam>& exams,
-    const std::vector<Group>& groups,
-    const std::vector<Teacher>& teachers,
-    const std::vector<Room>& rooms,
-    const std::vector<Timeslot>& timeslots,
-    const std::vector<ExamAssignment>& assignments,
-    const std::string& sessionStartDate,
-    const std::string& sessionEndDate,
-    int maxExamsPerDayForGroup
-) {
-    ValidationResult result;
-    result.ok = true;
+ExamAssignment IncrementalValidator::apply(const ExamAssignment& move) {
+    checkMove(move);
+    int e = move.examIndex;
+    ExamAssignment previous = assignments_[e];
 
-    logInfo("=== Запуск проверки расписания ===");
-    logInfo("Экзаменов: " + std::to_string(exams.size()) +
-            ", назначений: " + std::to_string(assignments.size()) +
-            ", групп: " + std::to_string(groups.size()) +
-            ", преподавателей: " + std::to_string(teachers.size()) +
-            ", аудиторий: " + std::to_string(rooms.size()) +
-            ", слотов: " + std::to_string(timeslots.size()));
-
-    checkAllExamsAssigned(exams, assignments, result);
-    checkGroupConflicts(exams, groups, timeslots, assignments, result);
-    checkTeacherConflicts(exams, teachers, timeslots, assignments, result);
-    checkRoomConflicts(exams, groups, rooms, timeslots, assignments, result);
-    checkSessionBounds(timeslots, sessionStartDate, sessionEndDate, result);
-    checkMaxExamsPerDayForGroup(exams, groups, timeslots, assignments, maxExamsPerDayForGroup, result);
+    place(e, -1);
+    assignments_[e] = move;
+    slot_[e] = index_.timeslotIndex(move.timeslotId);
+    room_[e] = move.roomId < 0 ? -1 : index_.roomIndex(move.roomId);
+    place(e, +1);
 
-    if (result.ok) {
-        logInfo("Проверка расписания завершена: ошибок не обнаружено.");
-    } else {
-        logWarning("Проверка расписания завершена: обнаружено ошибок = " +
-                   std::to_string(result.errors.size()));
-    }
+    return previous;
+}
 
-    return result;
+ValidationResult IncrementalValidator::result() const {
+    ScheduleValidator validator;
+    return validator.checkAll(exams_, index_, assignments_, sessionStart_, sessionEnd_, maxPerDay_);
 }
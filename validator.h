@@ -2,12 +2,66 @@
 
 #pragma once
 
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class InstanceIndex;
+
+// Вид нарушения; в комментарии — что лежит в полях Violation
+enum class ViolationKind : unsigned char {
+    ExamIndexOutOfRange, // назначение ссылается на несуществующий examIndex
+    ExamNotAssigned,     // a = id экзамена
+    ExamMultiAssigned,   // a = id экзамена, count
+    GroupConflict,       // a = id группы, slot = id слота, count
+    TeacherConflict,     // a = id преподавателя, slot = id слота, count
+    RoomConflict,        // a = id аудитории, slot = id слота, count
+    GroupOverlap,        // a = id группы, slot и b = id двух разных слотов, пересекающихся по времени
+    TeacherOverlap,      // a = id преподавателя, slot, b — как у GroupOverlap
+    RoomOverlap,         // a = id аудитории, slot, b — как у GroupOverlap
+    RoomMissing,         // a = examIndex
+    RoomDataError,       // a = id аудитории, b = id группы
+    RoomCapacity,        // a = id аудитории, b = id группы
+    SessionBounds,       // slot = позиция слота в index.timeslots()
+    DayTimeslotMissing,  // слот назначения не найден при подсчёте экзаменов в день
+    MaxPerDayExceeded,   // a = id группы, slot = номер дня в index, count
+    Note                 // готовый текст: a = индекс в ValidationResult::notes
+};
+
+// "GroupConflict", "RoomCapacity", ... — метка для логов
+const char* violationKindName(ViolationKind kind);
+
+// Нарушение без текста: текст собирается только при выдаче (renderViolations)
+struct Violation {
+    ViolationKind kind;
+    int a = -1;
+    int b = -1;
+    int slot = -1;
+    int count = 0;
+};
+
 struct ValidationResult {
     bool ok;                             // true, если ошибок нет
-    std::vector<std::string> errors;     // фатальные ошибки (конфликты)
+    std::vector<Violation> violations;   // фатальные ошибки (конфликты) в порядке проверок
+    std::vector<std::string> notes;      // тексты для ViolationKind::Note
     std::vector<std::string> warnings;   // необязательные замечания (по желанию)
+
+    // параметры проверки, нужные для текстов
+    std::string sessionStartDate;
+    std::string sessionEndDate;
+    int maxExamsPerDayForGroup = 0;
+
+    std::size_t errorCount() const { return violations.size(); }
+
+    // Ошибка с готовым текстом первой в списке (например, вывод точного поиска)
+    void prependNote(std::string text);
 };
 
+// Тексты ошибок для ответа API, по одной строке на нарушение.
+// index — тот же, по которому шла проверка
+std::vector<std::string> renderViolations(const ValidationResult& result, const InstanceIndex& index);
+std::string renderViolation(const ValidationResult& result, const Violation& v, const InstanceIndex& index);
+
 class ScheduleValidator {
     public:
         ValidationResult checkAll(
@@ -21,52 +75,71 @@ class ScheduleValidator {
             const std::string& sessionEndDate,
             int maxExamsPerDayForGroup
         ); // передаваемое
-    
-    private:
-        void checkGroupConflicts(
-            const std::vector<Exam>& exams,
-            const std::vector<Group>& groups,
-            const std::vector<Timeslot>& timeslots,
-            const std::vector<ExamAssignment>& assignments,
-            ValidationResult& result
-        ); 
-    
-        void checkTeacherConflicts(
-            const std::vector<Exam>& exams,
-            const std::vector<Teacher>& teachers,
-            const std::vector<Timeslot>& timeslots,
-            const std::vector<ExamAssignment>& assignments,
-            ValidationResult& result
-        ); 
 
-        void checkRoomConflicts(
+        // То же, но по заранее построенному индексу сущностей запроса.
+        // Все проверки — за один проход по назначениям с плоскими счётчиками
+        // (группа, слот), (преподаватель, слот), (аудитория, слот), (группа, день).
+        // Если слоты в index пересекаются по времени, занятые сущностью разные слоты
+        // дополнительно проверяются заметающей прямой по дням (Group/Teacher/RoomOverlap);
+        // порядок нарушений — как у прежних отдельных проверок, тексты — renderViolations
+        ValidationResult checkAll(
             const std::vector<Exam>& exams,
-            const std::vector<Group>& groups,
-            const std::vector<Room>& rooms,
-            const std::vector<Timeslot>& timeslots,
+            const InstanceIndex& index,
             const std::vector<ExamAssignment>& assignments,
-            ValidationResult& result
-        );
-        
-        void checkSessionBounds(
-            const std::vector<Timeslot>& timeslots,
             const std::string& sessionStartDate,
             const std::string& sessionEndDate,
-            ValidationResult& result
+            int maxExamsPerDayForGroup
         );
+    };
 
-        void checkAllExamsAssigned(
+// Проверка расписания, которое меняется по одному экзамену (оптимизация, редактор).
+// Держит те же счётчики, что и checkAll: (группа, слот), (преподаватель, слот),
+// (аудитория, слот), (группа, день), — и поддерживает число нарушений при каждом
+// apply/undo за O(1) (если слоты пересекаются по времени — ещё обход
+// index.overlappingTimeslots для слота экзамена). violations() всегда равно result().errorCount();
+// полный ValidationResult собирается только по запросу.
+// Слоты и аудитории в назначениях должны быть из index (иначе std::invalid_argument);
+// группы и преподаватели экзаменов — любые, как и в checkAll.
+class IncrementalValidator {
+    public:
+        // assignments — ровно по одному на экзамен (как возвращает generateSchedule)
+        IncrementalValidator(
             const std::vector<Exam>& exams,
+            const InstanceIndex& index,
             const std::vector<ExamAssignment>& assignments,
-            ValidationResult& result
+            const std::string& sessionStartDate,
+            const std::string& sessionEndDate,
+            int maxExamsPerDayForGroup
         );
 
-        void checkMaxExamsPerDayForGroup(
-            const std::vector<Exam>& exams,
-            const std::vector<Group>& groups,
-            const std::vector<Timeslot>& timeslots,
-            const std::vector<ExamAssignment>& assignments,
-            int maxPerDay,
-            ValidationResult& result
-        );
-    };
\ No newline at end of file
+        // Ставит экзамен move.examIndex в move.timeslotId / move.roomId (roomId < 0 —
+        // без аудитории). Возвращает прежнее положение — его же передать в undo
+        ExamAssignment apply(const ExamAssignment& move);
+        void undo(const ExamAssignment& previous) { apply(previous); }
+
+        int violations() const { return violations_; }
+        const std::vector<ExamAssignment>& assignments() const { return assignments_; }
+
+        // То же, что ScheduleValidator::checkAll по текущим назначениям
+        ValidationResult result() const;
+
+    private:
+        void place(int exam, int sign); // +1 — учесть текущее положение экзамена, -1 — убрать
+        void checkMove(const ExamAssignment& move) const;
+
+        const std::vector<Exam>& exams_;
+        const InstanceIndex& index_;
+        std::string sessionStart_;
+        std::string sessionEnd_;
+        int maxPerDay_;
+
+        std::vector<ExamAssignment> assignments_; // по examIndex
+        std::vector<int> group_, teacher_;        // плотные номера по экзамену
+        std::vector<char> knownGroup_;
+        std::vector<int> slot_, room_;            // индексы в index, room_ = -1 — без аудитории
+
+        int slotCount_;
+        int dayCount_;
+        std::vector<int> groupSlot_, teacherSlot_, roomSlot_, groupDay_;
+        int violations_ = 0;
+};